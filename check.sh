@@ -9,14 +9,17 @@
 bit_len=$1
 prefix=$2
 tmp=tmp.$$
-tmp64=tmp64.$$
-exps="19937"
+# the optional third argument is the list of the Mersenne exponents
+exps=${3:-"19937"}
 for mexp in $exps; do
     if [ $bit_len = "64" ]; then
-	./test-std-M${mexp} -b64 > $tmp64
-	compare=$tmp64
+	# the 32-bit outputs of the reference in pairs, the low word first
+	compare=SFMT.${mexp}.out64.txt
     else
 	compare=SFMT.${mexp}.out.txt
+	if [ ! -e $compare ]; then
+	    compare=Original-SFMT-1.3.3/SFMT.${mexp}.out.txt
+	fi
     fi
     command=${prefix}-M${mexp}
     if ./$command -b${bit_len}> $tmp; then
@@ -24,9 +27,6 @@ for mexp in $exps; do
     else
 	echo $command exexute error!
 	rm -f $tmp
-	if [ -n "$tmp64" ] && [ -e $tmp64 ]; then
-	    rm -f $tmp64
-	fi
 	exit 1
     fi
     if diff -q -w $tmp $compare; then
@@ -35,13 +35,7 @@ for mexp in $exps; do
     else
 	echo $command output check NG!
 	rm -f $tmp
-	if [ -n "$tmp64" ] && [ -e $tmp64 ]; then
-	    rm -f $tmp64
-	fi
 	exit 1
     fi
 done
-if [ -n "$tmp64" ] && [ -e $tmp64 ]; then
-    rm -f $tmp64
-fi
 exit 0
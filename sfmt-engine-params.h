@@ -0,0 +1,154 @@
+/* This file is a part of sfmt-extstate */
+
+/**
+ * @file  sfmt-engine-params.h
+ * @brief the traits class of a parameter set for sfmt-engine.hpp
+ *
+ * @author Kenji Rikitake
+ *
+ * Copyright (C) 2010 Kenji Rikitake. All rights reserved.
+ *
+ * The new BSD License is applied to this software, see LICENSE.txt
+ *
+ * @note This file is included by sfmt-engine.hpp once for each
+ * parameter set, with SFMT_ENGINE_PARAMS the name of its sfmt-params-M*.h
+ * and SFMT_ENGINE_TRAITS the name of the traits class, which is made of
+ * the macros of that file.  The macros of the parameter files and their
+ * include guards are saved before and restored after, so that a program
+ * which defines MEXP, N etc. itself keeps them.  There is no include
+ * guard.
+ */
+
+#pragma push_macro("MEXP")
+#pragma push_macro("N")
+#pragma push_macro("N32")
+#pragma push_macro("POS1")
+#pragma push_macro("SL1")
+#pragma push_macro("SL2")
+#pragma push_macro("SR1")
+#pragma push_macro("SR2")
+#pragma push_macro("MSK1")
+#pragma push_macro("MSK2")
+#pragma push_macro("MSK3")
+#pragma push_macro("MSK4")
+#pragma push_macro("PARITY1")
+#pragma push_macro("PARITY2")
+#pragma push_macro("PARITY3")
+#pragma push_macro("PARITY4")
+#pragma push_macro("IDSTR")
+#pragma push_macro("SFMT_PARAMS_M607_H")
+#pragma push_macro("SFMT_PARAMS_M1279_H")
+#pragma push_macro("SFMT_PARAMS_M2281_H")
+#pragma push_macro("SFMT_PARAMS_M4253_H")
+#pragma push_macro("SFMT_PARAMS_M11213_H")
+#pragma push_macro("SFMT_PARAMS_M19937_H")
+#pragma push_macro("SFMT_PARAMS_M44497_H")
+#pragma push_macro("SFMT_PARAMS_M86243_H")
+#pragma push_macro("SFMT_PARAMS_M132049_H")
+#pragma push_macro("SFMT_PARAMS_M216091_H")
+#undef MEXP
+#undef N
+#undef N32
+#undef POS1
+#undef SL1
+#undef SL2
+#undef SR1
+#undef SR2
+#undef MSK1
+#undef MSK2
+#undef MSK3
+#undef MSK4
+#undef PARITY1
+#undef PARITY2
+#undef PARITY3
+#undef PARITY4
+#undef IDSTR
+#undef SFMT_PARAMS_M607_H
+#undef SFMT_PARAMS_M1279_H
+#undef SFMT_PARAMS_M2281_H
+#undef SFMT_PARAMS_M4253_H
+#undef SFMT_PARAMS_M11213_H
+#undef SFMT_PARAMS_M19937_H
+#undef SFMT_PARAMS_M44497_H
+#undef SFMT_PARAMS_M86243_H
+#undef SFMT_PARAMS_M132049_H
+#undef SFMT_PARAMS_M216091_H
+
+#include SFMT_ENGINE_PARAMS
+
+struct SFMT_ENGINE_TRAITS {
+    static constexpr int mexp = MEXP;
+    static constexpr int pos1 = POS1;
+    static constexpr int sl1 = SL1;
+    static constexpr int sl2 = SL2;
+    static constexpr int sr1 = SR1;
+    static constexpr int sr2 = SR2;
+    static constexpr uint32_t msk1 = MSK1;
+    static constexpr uint32_t msk2 = MSK2;
+    static constexpr uint32_t msk3 = MSK3;
+    static constexpr uint32_t msk4 = MSK4;
+    static constexpr uint32_t parity1 = PARITY1;
+    static constexpr uint32_t parity2 = PARITY2;
+    static constexpr uint32_t parity3 = PARITY3;
+    static constexpr uint32_t parity4 = PARITY4;
+    static const char *idstring() {
+	return IDSTR;
+    }
+};
+
+#undef MEXP
+#undef N
+#undef N32
+#undef POS1
+#undef SL1
+#undef SL2
+#undef SR1
+#undef SR2
+#undef MSK1
+#undef MSK2
+#undef MSK3
+#undef MSK4
+#undef PARITY1
+#undef PARITY2
+#undef PARITY3
+#undef PARITY4
+#undef IDSTR
+#undef SFMT_PARAMS_M607_H
+#undef SFMT_PARAMS_M1279_H
+#undef SFMT_PARAMS_M2281_H
+#undef SFMT_PARAMS_M4253_H
+#undef SFMT_PARAMS_M11213_H
+#undef SFMT_PARAMS_M19937_H
+#undef SFMT_PARAMS_M44497_H
+#undef SFMT_PARAMS_M86243_H
+#undef SFMT_PARAMS_M132049_H
+#undef SFMT_PARAMS_M216091_H
+#pragma pop_macro("MEXP")
+#pragma pop_macro("N")
+#pragma pop_macro("N32")
+#pragma pop_macro("POS1")
+#pragma pop_macro("SL1")
+#pragma pop_macro("SL2")
+#pragma pop_macro("SR1")
+#pragma pop_macro("SR2")
+#pragma pop_macro("MSK1")
+#pragma pop_macro("MSK2")
+#pragma pop_macro("MSK3")
+#pragma pop_macro("MSK4")
+#pragma pop_macro("PARITY1")
+#pragma pop_macro("PARITY2")
+#pragma pop_macro("PARITY3")
+#pragma pop_macro("PARITY4")
+#pragma pop_macro("IDSTR")
+#pragma pop_macro("SFMT_PARAMS_M607_H")
+#pragma pop_macro("SFMT_PARAMS_M1279_H")
+#pragma pop_macro("SFMT_PARAMS_M2281_H")
+#pragma pop_macro("SFMT_PARAMS_M4253_H")
+#pragma pop_macro("SFMT_PARAMS_M11213_H")
+#pragma pop_macro("SFMT_PARAMS_M19937_H")
+#pragma pop_macro("SFMT_PARAMS_M44497_H")
+#pragma pop_macro("SFMT_PARAMS_M86243_H")
+#pragma pop_macro("SFMT_PARAMS_M132049_H")
+#pragma pop_macro("SFMT_PARAMS_M216091_H")
+#undef SFMT_ENGINE_PARAMS
+#undef SFMT_ENGINE_TRAITS
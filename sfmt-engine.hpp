@@ -0,0 +1,471 @@
+/* This file is a part of sfmt-extstate */
+
+/**
+ * @file  sfmt-engine.hpp
+ * @brief header-only C++ engine of SFMT, specialized on the parameters
+ * at compile time
+ *
+ * @author Mutsuo Saito (Hiroshima University)
+ * @author Makoto Matsumoto (Hiroshima University)
+ * @author Kenji Rikitake
+ *
+ * Copyright (C) 2006,2007 Mutsuo Saito, Makoto Matsumoto and Hiroshima
+ * University. All rights reserved.
+ *
+ * Copyright (C) 2010 Kenji Rikitake. All rights reserved.
+ *
+ * The new BSD License is applied to this software, see LICENSE.txt
+ *
+ * @note sfmt_engine<Params> meets the UniformRandomBitGenerator
+ * requirements of C++11, and can be given to the distributions of
+ * <random>.  The parameters are the constexpr members of the traits
+ * classes sfmt_traits_M607 ... sfmt_traits_M216091, made of the macros
+ * of sfmt-params-M*.h by sfmt-engine-params.h, so that the loops of
+ * gen_rand_all() are compiled with constant bounds and shifts.  The
+ * output is the same as that of gen_rand32() of test.c with the same
+ * seed.  The SSE2 code is used when HAVE_SSE2 is defined.  Each
+ * engine owns its state table on the heap, so that moving an engine
+ * only moves a pointer; a moved-from engine must be seeded or assigned
+ * before use, and its copies are moved-from too.
+ */
+
+#ifndef SFMT_ENGINE_HPP
+#define SFMT_ENGINE_HPP
+
+#include <cstring>
+#include <memory>
+#include "sfmt-extstate.h"
+
+/* the parameter set of SFMT-607 */
+#define SFMT_ENGINE_PARAMS "sfmt-params-M607.h"
+#define SFMT_ENGINE_TRAITS sfmt_traits_M607
+#include "sfmt-engine-params.h"
+
+/* the parameter set of SFMT-1279 */
+#define SFMT_ENGINE_PARAMS "sfmt-params-M1279.h"
+#define SFMT_ENGINE_TRAITS sfmt_traits_M1279
+#include "sfmt-engine-params.h"
+
+/* the parameter set of SFMT-2281 */
+#define SFMT_ENGINE_PARAMS "sfmt-params-M2281.h"
+#define SFMT_ENGINE_TRAITS sfmt_traits_M2281
+#include "sfmt-engine-params.h"
+
+/* the parameter set of SFMT-4253 */
+#define SFMT_ENGINE_PARAMS "sfmt-params-M4253.h"
+#define SFMT_ENGINE_TRAITS sfmt_traits_M4253
+#include "sfmt-engine-params.h"
+
+/* the parameter set of SFMT-11213 */
+#define SFMT_ENGINE_PARAMS "sfmt-params-M11213.h"
+#define SFMT_ENGINE_TRAITS sfmt_traits_M11213
+#include "sfmt-engine-params.h"
+
+/* the parameter set of SFMT-19937 */
+#define SFMT_ENGINE_PARAMS "sfmt-params-M19937.h"
+#define SFMT_ENGINE_TRAITS sfmt_traits_M19937
+#include "sfmt-engine-params.h"
+
+/* the parameter set of SFMT-44497 */
+#define SFMT_ENGINE_PARAMS "sfmt-params-M44497.h"
+#define SFMT_ENGINE_TRAITS sfmt_traits_M44497
+#include "sfmt-engine-params.h"
+
+/* the parameter set of SFMT-86243 */
+#define SFMT_ENGINE_PARAMS "sfmt-params-M86243.h"
+#define SFMT_ENGINE_TRAITS sfmt_traits_M86243
+#include "sfmt-engine-params.h"
+
+/* the parameter set of SFMT-132049 */
+#define SFMT_ENGINE_PARAMS "sfmt-params-M132049.h"
+#define SFMT_ENGINE_TRAITS sfmt_traits_M132049
+#include "sfmt-engine-params.h"
+
+/* the parameter set of SFMT-216091 */
+#define SFMT_ENGINE_PARAMS "sfmt-params-M216091.h"
+#define SFMT_ENGINE_TRAITS sfmt_traits_M216091
+#include "sfmt-engine-params.h"
+
+/**
+ * SFMT engine of the parameter set Params.
+ */
+template <class Params>
+class sfmt_engine {
+public:
+    /** type of the output */
+    typedef uint32_t result_type;
+    /** the parameter set */
+    typedef Params params_type;
+    /** Mersenne exponent */
+    static constexpr int mexp = Params::mexp;
+    /** size of the internal state array in 128-bit integers */
+    static constexpr int n = mexp / 128 + 1;
+    /** size of the internal state array in 32-bit integers */
+    static constexpr int n32 = n * 4;
+    /** seed of the default constructor */
+    static constexpr result_type default_seed = 1234U;
+
+    /**
+     * The constructor initializes the state with a 32-bit seed, as
+     * init_gen_rand().
+     * @param s a 32-bit integer used as the seed.
+     */
+    explicit sfmt_engine(result_type s = default_seed)
+	: state(new w128_t[n]) {
+	seed(s);
+    }
+
+    /**
+     * The constructor initializes the state with an array of 32-bit
+     * integers, as init_by_array().
+     * @param init_key the array of 32-bit integers, used as a seed.
+     * @param key_length the length of init_key.
+     */
+    sfmt_engine(const uint32_t *init_key, int key_length)
+	: state(new w128_t[n]) {
+	seed(init_key, key_length);
+    }
+
+    /**
+     * The copy constructor copies the state table.  The copy of a
+     * moved-from engine is moved-from too.
+     * @param other the engine to be copied
+     */
+    sfmt_engine(const sfmt_engine& other)
+	: idx(other.idx) {
+	if (other.state) {
+	    state.reset(new w128_t[n]);
+	    std::memcpy(state.get(), other.state.get(), sizeof(w128_t) * n);
+	}
+    }
+
+    /**
+     * The copy assignment copies the state table.  Assigning a
+     * moved-from engine makes this engine moved-from too.
+     * @param other the engine to be copied
+     * @return this engine
+     */
+    sfmt_engine& operator=(const sfmt_engine& other) {
+	if (this != &other) {
+	    if (!other.state) {
+		state.reset();
+	    } else {
+		if (!state) {
+		    state.reset(new w128_t[n]);
+		}
+		std::memcpy(state.get(), other.state.get(),
+			    sizeof(w128_t) * n);
+	    }
+	    idx = other.idx;
+	}
+	return *this;
+    }
+
+    /* moves only take over the state table */
+    sfmt_engine(sfmt_engine&& other) noexcept = default;
+    sfmt_engine& operator=(sfmt_engine&& other) noexcept = default;
+
+    /**
+     * This function initializes the state with a 32-bit seed, as
+     * init_gen_rand().
+     * @param s a 32-bit integer used as the seed.
+     */
+    void seed(result_type s = default_seed) {
+	uint32_t *state32;
+	int i;
+
+	if (!state) {
+	    state.reset(new w128_t[n]);
+	}
+	state32 = &state[0].u[0];
+	state32[0] = s;
+	for (i = 1; i < n32; i++) {
+	    state32[i] = 1812433253UL * (state32[i - 1]
+					 ^ (state32[i - 1] >> 30))
+		+ i;
+	}
+	period_certification();
+	idx = n32;
+    }
+
+    /**
+     * This function initializes the state with an array of 32-bit
+     * integers, as init_by_array().
+     * @param init_key the array of 32-bit integers, used as a seed.
+     * @param key_length the length of init_key.
+     */
+    void seed(const uint32_t *init_key, int key_length) {
+	int i, j, count;
+	uint32_t r;
+	uint32_t *state32;
+	const int lag = n32 >= 623 ? 11 : n32 >= 68 ? 7 : n32 >= 39 ? 5 : 3;
+	const int mid = (n32 - lag) / 2;
+
+	if (!state) {
+	    state.reset(new w128_t[n]);
+	}
+	state32 = &state[0].u[0];
+	std::memset(state32, 0x8b, sizeof(w128_t) * n);
+	count = key_length + 1 > n32 ? key_length + 1 : n32;
+	r = func1(state32[0] ^ state32[mid] ^ state32[n32 - 1]);
+	state32[mid] += r;
+	r += key_length;
+	state32[mid + lag] += r;
+	state32[0] = r;
+
+	count--;
+	for (i = 1, j = 0; (j < count) && (j < key_length); j++) {
+	    r = func1(state32[i] ^ state32[(i + mid) % n32]
+		      ^ state32[(i + n32 - 1) % n32]);
+	    state32[(i + mid) % n32] += r;
+	    r += init_key[j] + i;
+	    state32[(i + mid + lag) % n32] += r;
+	    state32[i] = r;
+	    i = (i + 1) % n32;
+	}
+	for (; j < count; j++) {
+	    r = func1(state32[i] ^ state32[(i + mid) % n32]
+		      ^ state32[(i + n32 - 1) % n32]);
+	    state32[(i + mid) % n32] += r;
+	    r += i;
+	    state32[(i + mid + lag) % n32] += r;
+	    state32[i] = r;
+	    i = (i + 1) % n32;
+	}
+	for (j = 0; j < n32; j++) {
+	    r = func2(state32[i] + state32[(i + mid) % n32]
+		      + state32[(i + n32 - 1) % n32]);
+	    state32[(i + mid) % n32] ^= r;
+	    r -= i;
+	    state32[(i + mid + lag) % n32] ^= r;
+	    state32[i] = r;
+	    i = (i + 1) % n32;
+	}
+	period_certification();
+	idx = n32;
+    }
+
+    /**
+     * This function generates and returns a 32-bit pseudorandom number.
+     * @return 32-bit pseudorandom number
+     */
+    result_type operator()() {
+	if (idx >= n32) {
+	    gen_rand_all();
+	    idx = 0;
+	}
+	return (&state[0].u[0])[idx++];
+    }
+
+    /**
+     * This function skips pseudorandom numbers: the rest of the current
+     * table, then whole tables by gen_rand_all(), and the index in the
+     * last one.
+     * @param z the number of 32-bit pseudorandom numbers to be skipped
+     */
+    void discard(unsigned long long z) {
+	if (z <= (unsigned long long)(n32 - idx)) {
+	    idx += (int)z;
+	    return;
+	}
+	z -= n32 - idx;
+	for (; z > (unsigned long long)n32; z -= n32) {
+	    gen_rand_all();
+	}
+	gen_rand_all();
+	idx = (int)z;
+    }
+
+    /** @return the smallest output */
+    static constexpr result_type min() {
+	return 0;
+    }
+
+    /** @return the largest output */
+    static constexpr result_type max() {
+	return 0xffffffffU;
+    }
+
+    /** @return the identification string of the parameter set */
+    static const char *idstring() {
+	return Params::idstring();
+    }
+
+private:
+    /** the internal state array */
+    std::unique_ptr<w128_t[]> state;
+    /** index counter to the 32-bit internal state array */
+    int idx;
+
+    /**
+     * This function represents a function used in the initialization
+     * by init_by_array
+     * @param x 32-bit integer
+     * @return 32-bit integer
+     */
+    static uint32_t func1(uint32_t x) {
+	return (x ^ (x >> 27)) * (uint32_t)1664525UL;
+    }
+
+    /**
+     * This function represents a function used in the initialization
+     * by init_by_array
+     * @param x 32-bit integer
+     * @return 32-bit integer
+     */
+    static uint32_t func2(uint32_t x) {
+	return (x ^ (x >> 27)) * (uint32_t)1566083941UL;
+    }
+
+    /**
+     * This function certificate the period of 2^{MEXP}
+     */
+    void period_certification() {
+	static const uint32_t parity[4] = {Params::parity1, Params::parity2,
+					   Params::parity3, Params::parity4};
+	uint32_t *state32 = &state[0].u[0];
+	uint32_t inner = 0;
+	uint32_t work;
+	int i, j;
+
+	for (i = 0; i < 4; i++) {
+	    inner ^= state32[i] & parity[i];
+	}
+	for (i = 16; i > 0; i >>= 1) {
+	    inner ^= inner >> i;
+	}
+	if ((inner & 1) == 1) {
+	    return;
+	}
+	for (i = 0; i < 4; i++) {
+	    work = 1;
+	    for (j = 0; j < 32; j++) {
+		if ((work & parity[i]) != 0) {
+		    state32[i] ^= work;
+		    return;
+		}
+		work = work << 1;
+	    }
+	}
+    }
+
+#if defined(HAVE_SSE2)
+    /**
+     * This function represents the recursion formula.
+     * @param a a 128-bit part of the interal state array
+     * @param b a 128-bit part of the interal state array
+     * @param c a 128-bit part of the interal state array
+     * @param d a 128-bit part of the interal state array
+     * @param mask 128-bit mask
+     * @return output
+     */
+    static __m128i mm_recursion(__m128i a, __m128i b, __m128i c, __m128i d,
+				__m128i mask) {
+	__m128i x, y, z;
+
+	y = _mm_and_si128(_mm_srli_epi32(b, Params::sr1), mask);
+	z = _mm_xor_si128(_mm_srli_si128(c, Params::sr2), a);
+	z = _mm_xor_si128(z, _mm_slli_epi32(d, Params::sl1));
+	x = _mm_slli_si128(a, Params::sl2);
+	z = _mm_xor_si128(z, x);
+	return _mm_xor_si128(z, y);
+    }
+
+    /**
+     * This function fills the internal state array with pseudorandom
+     * integers.
+     */
+    void gen_rand_all() {
+	w128_t *s = state.get();
+	__m128i r, r1, r2;
+	const __m128i mask = _mm_set_epi32(Params::msk4, Params::msk3,
+					   Params::msk2, Params::msk1);
+	int i;
+
+	r1 = _mm_load_si128(&s[n - 2].si);
+	r2 = _mm_load_si128(&s[n - 1].si);
+	for (i = 0; i < n - Params::pos1; i++) {
+	    r = mm_recursion(s[i].si, s[i + Params::pos1].si, r1, r2, mask);
+	    _mm_store_si128(&s[i].si, r);
+	    r1 = r2;
+	    r2 = r;
+	}
+	for (; i < n; i++) {
+	    r = mm_recursion(s[i].si, s[i + Params::pos1 - n].si, r1, r2,
+			     mask);
+	    _mm_store_si128(&s[i].si, r);
+	    r1 = r2;
+	    r2 = r;
+	}
+    }
+#else
+    /**
+     * This function represents the recursion formula.
+     * @param r output
+     * @param a a 128-bit part of the internal state array
+     * @param b a 128-bit part of the internal state array
+     * @param c a 128-bit part of the internal state array
+     * @param d a 128-bit part of the internal state array
+     */
+    static void do_recursion(w128_t *r, const w128_t *a, const w128_t *b,
+			     const w128_t *c, const w128_t *d) {
+	uint64_t ah, al, ch, cl, xh, xl, yh, yl;
+
+	ah = ((uint64_t)a->u[3] << 32) | a->u[2];
+	al = ((uint64_t)a->u[1] << 32) | a->u[0];
+	ch = ((uint64_t)c->u[3] << 32) | c->u[2];
+	cl = ((uint64_t)c->u[1] << 32) | c->u[0];
+	xh = (ah << (Params::sl2 * 8)) | (al >> (64 - Params::sl2 * 8));
+	xl = al << (Params::sl2 * 8);
+	yh = ch >> (Params::sr2 * 8);
+	yl = (cl >> (Params::sr2 * 8)) | (ch << (64 - Params::sr2 * 8));
+	r->u[0] = a->u[0] ^ (uint32_t)xl ^ ((b->u[0] >> Params::sr1)
+					     & Params::msk1)
+	    ^ (uint32_t)yl ^ (d->u[0] << Params::sl1);
+	r->u[1] = a->u[1] ^ (uint32_t)(xl >> 32) ^ ((b->u[1] >> Params::sr1)
+						     & Params::msk2)
+	    ^ (uint32_t)(yl >> 32) ^ (d->u[1] << Params::sl1);
+	r->u[2] = a->u[2] ^ (uint32_t)xh ^ ((b->u[2] >> Params::sr1)
+					     & Params::msk3)
+	    ^ (uint32_t)yh ^ (d->u[2] << Params::sl1);
+	r->u[3] = a->u[3] ^ (uint32_t)(xh >> 32) ^ ((b->u[3] >> Params::sr1)
+						     & Params::msk4)
+	    ^ (uint32_t)(yh >> 32) ^ (d->u[3] << Params::sl1);
+    }
+
+    /**
+     * This function fills the internal state array with pseudorandom
+     * integers.
+     */
+    void gen_rand_all() {
+	w128_t *s = state.get();
+	w128_t *r1, *r2;
+	int i;
+
+	r1 = &s[n - 2];
+	r2 = &s[n - 1];
+	for (i = 0; i < n - Params::pos1; i++) {
+	    do_recursion(&s[i], &s[i], &s[i + Params::pos1], r1, r2);
+	    r1 = r2;
+	    r2 = &s[i];
+	}
+	for (; i < n; i++) {
+	    do_recursion(&s[i], &s[i], &s[i + Params::pos1 - n], r1, r2);
+	    r1 = r2;
+	    r2 = &s[i];
+	}
+    }
+#endif /* HAVE_SSE2 */
+};
+
+template <class Params> constexpr int sfmt_engine<Params>::mexp;
+template <class Params> constexpr int sfmt_engine<Params>::n;
+template <class Params> constexpr int sfmt_engine<Params>::n32;
+template <class Params>
+constexpr typename sfmt_engine<Params>::result_type
+sfmt_engine<Params>::default_seed;
+
+/** SFMT engine of the period 2^19937-1, as std::mt19937 */
+typedef sfmt_engine<sfmt_traits_M19937> sfmt19937;
+
+#endif /* SFMT_ENGINE_HPP */
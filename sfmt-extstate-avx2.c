@@ -0,0 +1,221 @@
+/* This file is a part of sfmt-extstate */
+
+/**
+ * @file  sfmt-extstate-avx2.c
+ * @brief SFMT table manipulation functions with AVX2 instructions
+ *
+ * @author Mutsuo Saito (Hiroshima University)
+ * @author Makoto Matsumoto (Hiroshima University)
+ * @author Kenji Rikitake
+ *
+ * Copyright (C) 2006,2007 Mutsuo Saito, Makoto Matsumoto and Hiroshima
+ * University. All rights reserved.
+ *
+ * Copyright (C) 2010 Kenji Rikitake. All rights reserved.
+ *
+ * The new BSD License is applied to this software, see LICENSE.txt
+ *
+ * @note The single-stream functions are those of sfmt-extstate-sse2.h,
+ * VEX-encoded by the compiler.  The two-stream functions put the
+ * 128-bit words of two independent state tables into the lower and the
+ * upper 128-bit lanes of a 256-bit register.  The byte shifts of AVX2
+ * work within each 128-bit lane, so that each lane computes exactly the
+ * same recursion as the SSE2 code.
+ */
+#include <string.h>
+#include <assert.h>
+#include "sfmt-params.h"
+#include "sfmt-extstate.h"
+
+#if defined(HAVE_AVX2)
+
+/* AVX2-specific prototypes */
+PRE_ALWAYS __m256i mm256_recursion(__m256i a, __m256i b, __m256i c,
+				   __m256i d, __m256i mask) ALWAYSINLINE;
+PRE_ALWAYS __m256i mm256_load2(w128_t *p0, w128_t *p1) ALWAYSINLINE;
+PRE_ALWAYS void mm256_store2(w128_t *p0, w128_t *p1, __m256i r)
+    ALWAYSINLINE;
+
+/* public functions for two and four state tables */
+inline void gen_rand_all_x2(w128_t *intstate[2]);
+inline void gen_rand_array_x2(w128_t *array[2], int size,
+			      w128_t *intstate[2]);
+void gen_rand_all_x4(w128_t *intstate[4]);
+void gen_rand_array_x4(w128_t *array[4], int size, w128_t *intstate[4]);
+
+/* the single-stream functions for the state tables */
+#include "sfmt-extstate-sse2.h"
+
+/* AVX2 assembly language code */
+
+/**
+ * This function represents the recursion formula for two streams,
+ * one stream for each 128-bit lane.
+ * @param a 128-bit parts of the interal state arrays
+ * @param b 128-bit parts of the interal state arrays
+ * @param c 128-bit parts of the interal state arrays
+ * @param d 128-bit parts of the interal state arrays
+ * @param mask 128-bit mask in both lanes
+ * @return output
+ */
+PRE_ALWAYS __m256i mm256_recursion(__m256i a, __m256i b,
+				   __m256i c, __m256i d, __m256i mask) {
+    __m256i v, x, y, z;
+
+    y = _mm256_srli_epi32(b, SR1);
+    z = _mm256_srli_si256(c, SR2);
+    v = _mm256_slli_epi32(d, SL1);
+    z = _mm256_xor_si256(z, a);
+    z = _mm256_xor_si256(z, v);
+    x = _mm256_slli_si256(a, SL2);
+    y = _mm256_and_si256(y, mask);
+    z = _mm256_xor_si256(z, x);
+    z = _mm256_xor_si256(z, y);
+    return z;
+}
+
+/**
+ * This function loads two 128-bit words into a 256-bit register.
+ * @param p0 128-bit word of the stream 0, loaded into the lower lane
+ * @param p1 128-bit word of the stream 1, loaded into the upper lane
+ * @return 256-bit register
+ */
+PRE_ALWAYS __m256i mm256_load2(w128_t *p0, w128_t *p1) {
+    return _mm256_inserti128_si256(
+	_mm256_castsi128_si256(_mm_load_si128(&p0->si)),
+	_mm_load_si128(&p1->si), 1);
+}
+
+/**
+ * This function stores a 256-bit register into two 128-bit words.
+ * @param p0 128-bit word of the stream 0, stored from the lower lane
+ * @param p1 128-bit word of the stream 1, stored from the upper lane
+ * @param r 256-bit register
+ */
+PRE_ALWAYS void mm256_store2(w128_t *p0, w128_t *p1, __m256i r) {
+    _mm_store_si128(&p0->si, _mm256_castsi256_si128(r));
+    _mm_store_si128(&p1->si, _mm256_extracti128_si256(r, 1));
+}
+
+/**
+ * This function fills two internal state arrays with pseudorandom
+ * integers.  The result of each array is the same as that of
+ * gen_rand_all().
+ * @param intstate internal state arrays of the two streams
+ */
+inline void gen_rand_all_x2(w128_t *intstate[2]) {
+    int i;
+    w128_t *s0 = intstate[0];
+    w128_t *s1 = intstate[1];
+    __m256i r, r1, r2, mask;
+    mask = _mm256_set_epi32(MSK4, MSK3, MSK2, MSK1, MSK4, MSK3, MSK2, MSK1);
+
+    r1 = mm256_load2(&s0[N - 2], &s1[N - 2]);
+    r2 = mm256_load2(&s0[N - 1], &s1[N - 1]);
+    for (i = 0; i < N - POS1; i++) {
+	r = mm256_recursion(mm256_load2(&s0[i], &s1[i]),
+			    mm256_load2(&s0[i + POS1], &s1[i + POS1]),
+			    r1, r2, mask);
+	mm256_store2(&s0[i], &s1[i], r);
+	r1 = r2;
+	r2 = r;
+    }
+    for (; i < N; i++) {
+	r = mm256_recursion(mm256_load2(&s0[i], &s1[i]),
+			    mm256_load2(&s0[i + POS1 - N], &s1[i + POS1 - N]),
+			    r1, r2, mask);
+	mm256_store2(&s0[i], &s1[i], r);
+	r1 = r2;
+	r2 = r;
+    }
+}
+
+/**
+ * This function fills two user-specified arrays with pseudorandom
+ * integers.  The result of each array and each internal state array
+ * is the same as that of gen_rand_array().
+ *
+ * @param array 128-bit arrays of the two streams to be filled by
+ * pseudorandom numbers.
+ * @param size number of 128-bit pesudorandom numbers to be generated
+ * for each stream.
+ * @param intstate internal state arrays of the two streams
+ */
+inline void gen_rand_array_x2(w128_t *array[2], int size,
+			      w128_t *intstate[2]) {
+    int i, j;
+    w128_t *a0 = array[0];
+    w128_t *a1 = array[1];
+    w128_t *s0 = intstate[0];
+    w128_t *s1 = intstate[1];
+    __m256i r, r1, r2, mask;
+    mask = _mm256_set_epi32(MSK4, MSK3, MSK2, MSK1, MSK4, MSK3, MSK2, MSK1);
+
+    r1 = mm256_load2(&s0[N - 2], &s1[N - 2]);
+    r2 = mm256_load2(&s0[N - 1], &s1[N - 1]);
+    for (i = 0; i < N - POS1; i++) {
+	r = mm256_recursion(mm256_load2(&s0[i], &s1[i]),
+			    mm256_load2(&s0[i + POS1], &s1[i + POS1]),
+			    r1, r2, mask);
+	mm256_store2(&a0[i], &a1[i], r);
+	r1 = r2;
+	r2 = r;
+    }
+    for (; i < N; i++) {
+	r = mm256_recursion(mm256_load2(&s0[i], &s1[i]),
+			    mm256_load2(&a0[i + POS1 - N], &a1[i + POS1 - N]),
+			    r1, r2, mask);
+	mm256_store2(&a0[i], &a1[i], r);
+	r1 = r2;
+	r2 = r;
+    }
+    /* main loop */
+    for (; i < size - N; i++) {
+	r = mm256_recursion(mm256_load2(&a0[i - N], &a1[i - N]),
+			    mm256_load2(&a0[i + POS1 - N], &a1[i + POS1 - N]),
+			    r1, r2, mask);
+	mm256_store2(&a0[i], &a1[i], r);
+	r1 = r2;
+	r2 = r;
+    }
+    for (j = 0; j < 2 * N - size; j++) {
+	s0[j] = a0[j + size - N];
+	s1[j] = a1[j + size - N];
+    }
+    for (; i < size; i++, j++) {
+	r = mm256_recursion(mm256_load2(&a0[i - N], &a1[i - N]),
+			    mm256_load2(&a0[i + POS1 - N], &a1[i + POS1 - N]),
+			    r1, r2, mask);
+	mm256_store2(&a0[i], &a1[i], r);
+	mm256_store2(&s0[j], &s1[j], r);
+	r1 = r2;
+	r2 = r;
+    }
+}
+
+/**
+ * This function fills four internal state arrays with pseudorandom
+ * integers, two streams at a time.
+ * @param intstate internal state arrays of the four streams
+ */
+void gen_rand_all_x4(w128_t *intstate[4]) {
+    gen_rand_all_x2(&intstate[0]);
+    gen_rand_all_x2(&intstate[2]);
+}
+
+/**
+ * This function fills four user-specified arrays with pseudorandom
+ * integers, two streams at a time.
+ *
+ * @param array 128-bit arrays of the four streams to be filled by
+ * pseudorandom numbers.
+ * @param size number of 128-bit pseudorandom numbers to be generated
+ * for each stream.
+ * @param intstate internal state arrays of the four streams
+ */
+void gen_rand_array_x4(w128_t *array[4], int size, w128_t *intstate[4]) {
+    gen_rand_array_x2(&array[0], size, &intstate[0]);
+    gen_rand_array_x2(&array[2], size, &intstate[2]);
+}
+
+#endif /* defined(HAVE_AVX2) */
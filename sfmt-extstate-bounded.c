@@ -0,0 +1,141 @@
+/* This file is a part of sfmt-extstate */
+
+/**
+ * @file  sfmt-extstate-bounded.c
+ * @brief unbiased bounded integers from SFMT generator objects
+ *
+ * @author Kenji Rikitake
+ *
+ * Copyright (C) 2010 Kenji Rikitake. All rights reserved.
+ *
+ * The new BSD License is applied to this software, see LICENSE.txt
+ *
+ * @note An integer in [0, n) is the upper 32 bits of the 64-bit
+ * product x * n of a 32-bit output x, and x is rejected if the lower 32
+ * bits of the product are less than 2^32 mod n, which makes the result
+ * unbiased (D. Lemire, "Fast Random Integer Generation in an
+ * Interval", 2019).  The rejection rate is less than n / 2^32.  The bulk
+ * functions fill the array with raw 32-bit outputs by
+ * sfmt_fill_array32(), map them in place, four at a time with SSE2,
+ * and drop the rejected ones by compacting the array; the result is
+ * the same sequence as that of sfmt_next_bounded().
+ */
+#include "sfmt-extstate.h"
+
+/* static function prototypes */
+static int map_range(uint32_t *array, int size, uint32_t n, uint32_t lo);
+
+#if defined(HAVE_SSE2)
+/**
+ * This function maps the 32-bit integers of an array into [lo, lo + n)
+ * in place, and removes the rejected ones.
+ * @param array 32-bit integers, of any alignment
+ * @param size the number of the integers
+ * @param n the size of the range, not 0
+ * @param lo the lower bound of the range
+ * @return the number of the integers kept at the head of array
+ */
+static int map_range(uint32_t *array, int size, uint32_t n, uint32_t lo) {
+    int i, j, k;
+    uint64_t m;
+    uint32_t t = (0U - n) % n;
+    __m128i x, p02, p13, hi, lo32, reject;
+    const __m128i vn = _mm_set1_epi32(n);
+    const __m128i vlo = _mm_set1_epi32(lo);
+    const __m128i vt = _mm_set1_epi32(t ^ 0x80000000U);
+    const __m128i sign = _mm_set1_epi32(0x80000000U);
+    const __m128i even = _mm_set_epi32(0, -1, 0, -1);
+
+    for (i = 0, j = 0; i + 4 <= size; i += 4) {
+	x = _mm_loadu_si128((__m128i *)&array[i]);
+	p02 = _mm_mul_epu32(x, vn);
+	p13 = _mm_mul_epu32(_mm_srli_epi64(x, 32), vn);
+	hi = _mm_or_si128(_mm_srli_epi64(p02, 32),
+			  _mm_andnot_si128(even, p13));
+	lo32 = _mm_or_si128(_mm_and_si128(p02, even), _mm_slli_epi64(p13, 32));
+	reject = _mm_cmplt_epi32(_mm_xor_si128(lo32, sign), vt);
+	if (_mm_movemask_epi8(reject) == 0) {
+	    _mm_storeu_si128((__m128i *)&array[j], _mm_add_epi32(hi, vlo));
+	    j += 4;
+	    continue;
+	}
+	for (k = i; k < i + 4; k++) {
+	    m = (uint64_t)array[k] * n;
+	    if ((uint32_t)m >= t) {
+		array[j++] = (uint32_t)(m >> 32) + lo;
+	    }
+	}
+    }
+    for (; i < size; i++) {
+	m = (uint64_t)array[i] * n;
+	if ((uint32_t)m >= t) {
+	    array[j++] = (uint32_t)(m >> 32) + lo;
+	}
+    }
+    return j;
+}
+#else
+/**
+ * This function maps the 32-bit integers of an array into [lo, lo + n)
+ * in place, and removes the rejected ones.
+ * @param array 32-bit integers
+ * @param size the number of the integers
+ * @param n the size of the range, not 0
+ * @param lo the lower bound of the range
+ * @return the number of the integers kept at the head of array
+ */
+static int map_range(uint32_t *array, int size, uint32_t n, uint32_t lo) {
+    int i, j;
+    uint64_t m;
+    uint32_t t = (0U - n) % n;
+
+    for (i = 0, j = 0; i < size; i++) {
+	m = (uint64_t)array[i] * n;
+	if ((uint32_t)m >= t) {
+	    array[j++] = (uint32_t)(m >> 32) + lo;
+	}
+    }
+    return j;
+}
+#endif /* HAVE_SSE2 */
+
+/**
+ * This function generates unbiased pseudorandom integers in [0, n) in
+ * the specified array[] by one call, the same sequence as that of
+ * sfmt_next_bounded().
+ *
+ * @param sfmt the generator
+ * @param array an array where the integers are filled by this function.
+ * @param size the number of the integers to be generated.
+ * @param n the upper bound, exclusive; 0 stands for 2^32
+ */
+void sfmt_fill_array_bounded(sfmt_t *sfmt, uint32_t *array, int size,
+			     uint32_t n) {
+    sfmt_fill_array_range(sfmt, array, size, 0, n - 1);
+}
+
+/**
+ * This function generates unbiased pseudorandom integers in [lo, hi]
+ * in the specified array[] by one call, the same sequence as that of
+ * sfmt_next_range().
+ *
+ * @param sfmt the generator
+ * @param array an array where the integers are filled by this function.
+ * @param size the number of the integers to be generated.
+ * @param lo the lower bound, inclusive
+ * @param hi the upper bound, inclusive, not less than lo
+ */
+void sfmt_fill_array_range(sfmt_t *sfmt, uint32_t *array, int size,
+			   uint32_t lo, uint32_t hi) {
+    int done = 0;
+    uint32_t n = hi - lo + 1;
+
+    if (n == 0) {
+	sfmt_fill_array32(sfmt, array, size);
+	return;
+    }
+    while (done < size) {
+	sfmt_fill_array32(sfmt, array + done, size - done);
+	done += map_range(array + done, size - done, n, lo);
+    }
+}
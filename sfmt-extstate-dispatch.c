@@ -0,0 +1,416 @@
+/* This file is a part of sfmt-extstate */
+
+/**
+ * @file  sfmt-extstate-dispatch.c
+ * @brief run-time selection of the SFMT table manipulation backends
+ *
+ * @author Kenji Rikitake
+ *
+ * Copyright (C) 2010 Kenji Rikitake. All rights reserved.
+ *
+ * The new BSD License is applied to this software, see LICENSE.txt
+ *
+ * @note The backends sfmt-extstate-{std,sse2,avx2,avx512}.c are
+ * compiled for each Mersenne exponent of SFMT_MEXP_LIST with
+ * SFMT_BACKEND and SFMT_MEXP_NAMES defined, and linked together with
+ * this file.  The fastest backend the CPU and the OS support is
+ * selected once, at the program startup with GCC and compatible
+ * compilers, or by the first call of a table function or of
+ * sfmt_get_kernels() or sfmt_get_backend() otherwise.  Each table
+ * function then costs a check of the selection and one extra indirect
+ * jump.  The environment variable SFMT_EXTSTATE_BACKEND (std, sse2,
+ * avx2 or avx512) overrides the selection if the backend is supported.
+ *
+ * The table functions without a suffix (e.g. gen_rand_all) are those
+ * of the exponent 19937; those with a suffix (e.g. gen_rand_all_M607)
+ * are for the other exponents, and are also reachable from the
+ * parameter set descriptors (e.g. sfmt_params_M607.gen_rand_all).
+ */
+#include <stdlib.h>
+#include <string.h>
+#include "sfmt-extstate.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+  #include <cpuid.h>
+  #define HAVE_CPUID
+#endif
+
+/* public functions for the state tables */
+void gen_rand_all(w128_t *intstate);
+void gen_rand_all_reverse(w128_t *intstate);
+void gen_rand_slice(w128_t *next, w128_t *intstate, int start, int size);
+void gen_rand_array(w128_t *array, int size, w128_t *intstate);
+void gen_rand_all_double(w128_t *intstate, double *array);
+void gen_rand_all_float(w128_t *intstate, float *array);
+void gen_rand_all_x2(w128_t *intstate[2]);
+void gen_rand_array_x2(w128_t *array[2], int size, w128_t *intstate[2]);
+void gen_rand_all_x4(w128_t *intstate[4]);
+void gen_rand_array_x4(w128_t *array[4], int size, w128_t *intstate[4]);
+
+/* public functions for the run-time backend selection */
+const sfmt_kernels_t *sfmt_get_kernels(void);
+const char *sfmt_get_backend(void);
+int sfmt_set_backend(const char *name);
+const sfmt_params_t *sfmt_get_params(int mexp);
+
+/* static function prototypes */
+static int cpu_level(void);
+static int select_level(void);
+static int bound_level(void);
+
+/** defines the table functions of a backend */
+#define SFMT_KERNELS(backend, mexp) {					\
+	#backend,							\
+	SFMT_BACKEND_NAME(gen_rand_all, backend, mexp),			\
+	SFMT_BACKEND_NAME(gen_rand_all_reverse, backend, mexp),		\
+	SFMT_BACKEND_NAME(gen_rand_slice, backend, mexp),		\
+	SFMT_BACKEND_NAME(gen_rand_array, backend, mexp),		\
+	SFMT_BACKEND_NAME(gen_rand_all_double, backend, mexp),		\
+	SFMT_BACKEND_NAME(gen_rand_all_float, backend, mexp),		\
+	SFMT_BACKEND_NAME(gen_rand_all_x2, backend, mexp),		\
+	SFMT_BACKEND_NAME(gen_rand_array_x2, backend, mexp),		\
+	SFMT_BACKEND_NAME(gen_rand_all_x4, backend, mexp),		\
+	SFMT_BACKEND_NAME(gen_rand_array_x4, backend, mexp)		\
+    },
+
+/** defines the backends of an exponent, in the order of cpu_level() */
+#define SFMT_DEFINE_BACKENDS(mexp)					\
+    static const sfmt_kernels_t backends_M##mexp[] = {			\
+	SFMT_KERNELS(std, mexp)						\
+	SFMT_KERNELS(sse2, mexp)					\
+	SFMT_KERNELS(avx2, mexp)					\
+	SFMT_KERNELS(avx512, mexp)					\
+    };
+
+SFMT_MEXP_LIST(SFMT_DEFINE_BACKENDS)
+
+/** backend names, in the order of cpu_level() */
+static const char *backend_names[] = {"std", "sse2", "avx2", "avx512"};
+
+/** the selected backend, as an index of backends_M*, or -1 if none yet */
+static int level = -1;
+
+#if defined(__GNUC__)
+  #define LOAD_LEVEL() __atomic_load_n(&level, __ATOMIC_RELAXED)
+  #define STORE_LEVEL(l) __atomic_store_n(&level, (l), __ATOMIC_RELAXED)
+#else
+  /* the threads racing to select all store the same level */
+  #define LOAD_LEVEL() (*(volatile int *)&level)
+  #define STORE_LEVEL(l) (*(volatile int *)&level = (l))
+#endif
+
+/**
+ * This function returns the best backend level the CPU and the OS
+ * support: 0 for std, 1 for SSE2, 2 for AVX2 and 3 for AVX-512.
+ * @return backend level
+ */
+static int cpu_level(void) {
+#if defined(HAVE_CPUID)
+    unsigned int eax, ebx, ecx, edx;
+    unsigned int xcr0_lo, xcr0_hi;
+    int best = 0;
+
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+	return 0;
+    }
+    if ((edx & (1U << 26)) == 0) {
+	return 0;
+    }
+    best = 1;
+    /* OSXSAVE and AVX */
+    if ((ecx & (1U << 27)) == 0 || (ecx & (1U << 28)) == 0) {
+	return best;
+    }
+    __asm__ __volatile__ ("xgetbv" : "=a" (xcr0_lo), "=d" (xcr0_hi)
+			  : "c" (0));
+    /* XMM and YMM state enabled by the OS */
+    if ((xcr0_lo & 0x06) != 0x06 || __get_cpuid_max(0, NULL) < 7) {
+	return best;
+    }
+    __cpuid_count(7, 0, eax, ebx, ecx, edx);
+    /* AVX2 */
+    if ((ebx & (1U << 5)) == 0) {
+	return best;
+    }
+    best = 2;
+    /* opmask and ZMM state enabled by the OS,
+       AVX-512F, AVX-512BW and AVX-512VL */
+    if ((xcr0_lo & 0xe6) == 0xe6 && (ebx & (1U << 16)) != 0
+	&& (ebx & (1U << 30)) != 0 && (ebx & (1U << 31)) != 0) {
+	best = 3;
+    }
+    return best;
+#else
+    return 0;
+#endif
+}
+
+/**
+ * This function selects the backend to be bound.
+ * @return backend level
+ */
+static int select_level(void) {
+    int i;
+    int max = cpu_level();
+    const char *name = getenv("SFMT_EXTSTATE_BACKEND");
+
+    if (name != NULL) {
+	for (i = 0; i <= max; i++) {
+	    if (strcmp(name, backend_names[i]) == 0) {
+		return i;
+	    }
+	}
+    }
+    return max;
+}
+
+/**
+ * This function returns the bound backend, and binds the selected one
+ * if none is bound yet.
+ * @return backend level
+ */
+static int bound_level(void) {
+    int l = LOAD_LEVEL();
+
+    if (l < 0) {
+	l = select_level();
+	STORE_LEVEL(l);
+    }
+    return l;
+}
+
+#if defined(__GNUC__)
+static void sfmt_dispatch_init(void) __attribute__((constructor));
+
+/**
+ * This function binds the backend at the program startup, so that the
+ * first table function does not take the time to select it.
+ */
+static void sfmt_dispatch_init(void) {
+    bound_level();
+}
+#endif
+
+/**
+ * This function returns the table functions of the bound backend
+ * for the exponent 19937.
+ * @return the table functions of the backend
+ */
+const sfmt_kernels_t *sfmt_get_kernels(void) {
+    return &backends_M19937[bound_level()];
+}
+
+/**
+ * This function returns the name of the bound backend.
+ * @return backend name, one of "std", "sse2", "avx2" and "avx512"
+ */
+const char *sfmt_get_backend(void) {
+    return backend_names[bound_level()];
+}
+
+/**
+ * This function binds the named backend for all the exponents, if it
+ * is supported by the CPU and the OS.  It must not be called while
+ * another thread is calling a table function.
+ * @param name backend name, one of "std", "sse2", "avx2" and "avx512"
+ * @return 0 if bound, -1 if the backend is unknown or unsupported
+ */
+int sfmt_set_backend(const char *name) {
+    int i;
+    int max = cpu_level();
+
+    for (i = 0; i <= max; i++) {
+	if (strcmp(name, backend_names[i]) == 0) {
+	    STORE_LEVEL(i);
+	    return 0;
+	}
+    }
+    return -1;
+}
+
+/** returns the parameter set descriptor if its exponent matches */
+#define SFMT_FIND_PARAMS(m)						\
+    if (mexp == m) {							\
+	return &sfmt_params_M##m;					\
+    }
+
+/**
+ * This function returns the parameter set descriptor of a Mersenne
+ * exponent.
+ * @param mexp Mersenne exponent, one of SFMT_MEXP_LIST
+ * @return the descriptor, or NULL if mexp is not supported
+ */
+const sfmt_params_t *sfmt_get_params(int mexp) {
+    SFMT_MEXP_LIST(SFMT_FIND_PARAMS)
+    return NULL;
+}
+
+/** the table functions of the bound backend for an exponent */
+#define BOUND_BACKEND(mexp) backends_M##mexp[bound_level()]
+
+/**
+ * This macro defines the table functions of an exponent, which call
+ * the bound backend.  The functions are declared here to be referred
+ * from the parameter set descriptors.
+ */
+#define SFMT_DEFINE_DISPATCH(mexp)					\
+    void gen_rand_all_M##mexp(w128_t *intstate);			\
+    void gen_rand_all_reverse_M##mexp(w128_t *intstate);		\
+    void gen_rand_slice_M##mexp(w128_t *next, w128_t *intstate,	\
+				int start, int size);			\
+    void gen_rand_array_M##mexp(w128_t *array, int size,		\
+				w128_t *intstate);			\
+    void gen_rand_all_double_M##mexp(w128_t *intstate, double *array);	\
+    void gen_rand_all_float_M##mexp(w128_t *intstate, float *array);	\
+    void gen_rand_all_x2_M##mexp(w128_t *intstate[2]);			\
+    void gen_rand_array_x2_M##mexp(w128_t *array[2], int size,		\
+				   w128_t *intstate[2]);		\
+    void gen_rand_all_x4_M##mexp(w128_t *intstate[4]);			\
+    void gen_rand_array_x4_M##mexp(w128_t *array[4], int size,		\
+				   w128_t *intstate[4]);		\
+    void gen_rand_all_M##mexp(w128_t *intstate) {			\
+	BOUND_BACKEND(mexp).gen_rand_all(intstate);			\
+    }									\
+    void gen_rand_all_reverse_M##mexp(w128_t *intstate) {		\
+	BOUND_BACKEND(mexp).gen_rand_all_reverse(intstate);		\
+    }									\
+    void gen_rand_slice_M##mexp(w128_t *next, w128_t *intstate,	\
+				int start, int size) {			\
+	BOUND_BACKEND(mexp).gen_rand_slice(next, intstate, start, size); \
+    }									\
+    void gen_rand_array_M##mexp(w128_t *array, int size,		\
+				w128_t *intstate) {			\
+	BOUND_BACKEND(mexp).gen_rand_array(array, size, intstate);	\
+    }									\
+    void gen_rand_all_double_M##mexp(w128_t *intstate, double *array) { \
+	BOUND_BACKEND(mexp).gen_rand_all_double(intstate, array);	\
+    }									\
+    void gen_rand_all_float_M##mexp(w128_t *intstate, float *array) {	\
+	BOUND_BACKEND(mexp).gen_rand_all_float(intstate, array);	\
+    }									\
+    void gen_rand_all_x2_M##mexp(w128_t *intstate[2]) {		\
+	BOUND_BACKEND(mexp).gen_rand_all_x2(intstate);			\
+    }									\
+    void gen_rand_array_x2_M##mexp(w128_t *array[2], int size,		\
+				   w128_t *intstate[2]) {		\
+	BOUND_BACKEND(mexp).gen_rand_array_x2(array, size, intstate);	\
+    }									\
+    void gen_rand_all_x4_M##mexp(w128_t *intstate[4]) {		\
+	BOUND_BACKEND(mexp).gen_rand_all_x4(intstate);			\
+    }									\
+    void gen_rand_array_x4_M##mexp(w128_t *array[4], int size,		\
+				   w128_t *intstate[4]) {		\
+	BOUND_BACKEND(mexp).gen_rand_array_x4(array, size, intstate);	\
+    }
+
+SFMT_MEXP_LIST(SFMT_DEFINE_DISPATCH)
+
+/**
+ * This function fills the internal state array with pseudorandom
+ * integers, with the bound backend.
+ * @param intstate internal state array
+ */
+void gen_rand_all(w128_t *intstate) {
+    BOUND_BACKEND(19937).gen_rand_all(intstate);
+}
+
+/**
+ * This function restores the internal state array from before the
+ * last call of gen_rand_all(), with the bound backend.
+ * @param intstate internal state array
+ */
+void gen_rand_all_reverse(w128_t *intstate) {
+    BOUND_BACKEND(19937).gen_rand_all_reverse(intstate);
+}
+
+/**
+ * This function fills a part of the state table after intstate, with
+ * the bound backend.
+ * @param next the next state table being made
+ * @param intstate internal state array
+ * @param start the first 128-bit integer to fill
+ * @param size the number of 128-bit integers to fill
+ */
+void gen_rand_slice(w128_t *next, w128_t *intstate, int start, int size) {
+    BOUND_BACKEND(19937).gen_rand_slice(next, intstate, start, size);
+}
+
+/**
+ * This function fills the user-specified array with pseudorandom
+ * integers, with the bound backend.
+ *
+ * @param array an 128-bit array to be filled by pseudorandom numbers.
+ * @param size number of 128-bit pseudorandom numbers to be generated.
+ * @param intstate internal state array
+ */
+void gen_rand_array(w128_t *array, int size, w128_t *intstate) {
+    BOUND_BACKEND(19937).gen_rand_array(array, size, intstate);
+}
+
+/**
+ * This function fills the internal state array with pseudorandom
+ * integers, and converts them into doubles in [0, 1), with the bound
+ * backend.
+ * @param intstate internal state array
+ * @param array an array of N * 2 doubles to be filled
+ */
+void gen_rand_all_double(w128_t *intstate, double *array) {
+    BOUND_BACKEND(19937).gen_rand_all_double(intstate, array);
+}
+
+/**
+ * This function fills the internal state array with pseudorandom
+ * integers, and converts them into floats in [0, 1), with the bound
+ * backend.
+ * @param intstate internal state array
+ * @param array an array of N * 4 floats to be filled
+ */
+void gen_rand_all_float(w128_t *intstate, float *array) {
+    BOUND_BACKEND(19937).gen_rand_all_float(intstate, array);
+}
+
+/**
+ * This function fills two internal state arrays with pseudorandom
+ * integers, with the bound backend.
+ * @param intstate internal state arrays of the two streams
+ */
+void gen_rand_all_x2(w128_t *intstate[2]) {
+    BOUND_BACKEND(19937).gen_rand_all_x2(intstate);
+}
+
+/**
+ * This function fills two user-specified arrays with pseudorandom
+ * integers, with the bound backend.
+ *
+ * @param array 128-bit arrays of the two streams to be filled by
+ * pseudorandom numbers.
+ * @param size number of 128-bit pseudorandom numbers to be generated
+ * for each stream.
+ * @param intstate internal state arrays of the two streams
+ */
+void gen_rand_array_x2(w128_t *array[2], int size, w128_t *intstate[2]) {
+    BOUND_BACKEND(19937).gen_rand_array_x2(array, size, intstate);
+}
+
+/**
+ * This function fills four internal state arrays with pseudorandom
+ * integers, with the bound backend.
+ * @param intstate internal state arrays of the four streams
+ */
+void gen_rand_all_x4(w128_t *intstate[4]) {
+    BOUND_BACKEND(19937).gen_rand_all_x4(intstate);
+}
+
+/**
+ * This function fills four user-specified arrays with pseudorandom
+ * integers, with the bound backend.
+ *
+ * @param array 128-bit arrays of the four streams to be filled by
+ * pseudorandom numbers.
+ * @param size number of 128-bit pseudorandom numbers to be generated
+ * for each stream.
+ * @param intstate internal state arrays of the four streams
+ */
+void gen_rand_array_x4(w128_t *array[4], int size, w128_t *intstate[4]) {
+    BOUND_BACKEND(19937).gen_rand_array_x4(array, size, intstate);
+}
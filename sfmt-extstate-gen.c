@@ -0,0 +1,210 @@
+/* This file is a part of sfmt-extstate */
+
+/**
+ * @file  sfmt-extstate-gen.c
+ * @brief SFMT generator objects with a buffered output
+ *
+ * @author Kenji Rikitake
+ *
+ * Copyright (C) 2010 Kenji Rikitake. All rights reserved.
+ *
+ * The new BSD License is applied to this software, see LICENSE.txt
+ *
+ * @note A generator (sfmt_t) owns its state table and remembers how
+ * much of the table has been used as output, so that sfmt_next32()
+ * and sfmt_fill_array32() can be mixed freely: a fill first drains the
+ * unused 32-bit integers of the table, then lets gen_rand_array() write
+ * the rest directly into the array if the array is aligned, and leaves
+ * the remainder in the table.  The output is always the same sequence
+ * as that of sfmt_next32() alone.  The 64-bit outputs are pairs of
+ * 32-bit outputs, as described in sfmt-extstate.h.
+ */
+#define _POSIX_C_SOURCE 200112L
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "sfmt-extstate.h"
+
+/**
+ * This function allocates a generator of a Mersenne exponent.
+ * sfmt_init_gen_rand or sfmt_init_by_array must be called before
+ * generating.
+ * @param mexp Mersenne exponent, one of SFMT_MEXP_LIST
+ * @return the generator, or NULL if mexp is not supported or no memory
+ */
+sfmt_t *sfmt_new(int mexp) {
+    sfmt_t *sfmt;
+    void *state;
+    const sfmt_params_t *params = sfmt_get_params(mexp);
+
+    if (params == NULL) {
+	return NULL;
+    }
+    sfmt = malloc(sizeof(sfmt_t));
+    if (sfmt == NULL) {
+	return NULL;
+    }
+    if (posix_memalign(&state, 64, sizeof(w128_t) * params->n) != 0) {
+	free(sfmt);
+	return NULL;
+    }
+    sfmt->state = state;
+    sfmt->state32 = &sfmt->state[0].u[0];
+    sfmt->idx = params->n32;
+    sfmt->n32 = params->n32;
+    sfmt->params = params;
+    return sfmt;
+}
+
+/**
+ * This function frees a generator.
+ * @param sfmt the generator, or NULL
+ */
+void sfmt_free(sfmt_t *sfmt) {
+    if (sfmt != NULL) {
+	free(sfmt->state);
+	free(sfmt);
+    }
+}
+
+/**
+ * This function initializes a generator with a 32-bit integer seed.
+ * @param sfmt the generator
+ * @param seed a 32-bit integer used as the seed.
+ */
+void sfmt_init_gen_rand(sfmt_t *sfmt, uint32_t seed) {
+    sfmt->params->init_gen_rand(seed, sfmt->state);
+    sfmt->idx = sfmt->n32;
+}
+
+/**
+ * This function initializes a generator with an array of 32-bit
+ * integers used as the seeds.
+ * @param sfmt the generator
+ * @param init_key the array of 32-bit integers, used as a seed.
+ * @param key_length the length of init_key.
+ */
+void sfmt_init_by_array(sfmt_t *sfmt, uint32_t *init_key, int key_length) {
+    sfmt->params->init_by_array(init_key, key_length, sfmt->state);
+    sfmt->idx = sfmt->n32;
+}
+
+/**
+ * This function generates pseudorandom 32-bit integers in the
+ * specified array[] by one call, continuing the sequence of
+ * sfmt_next32().  Unlike fill_array32() of test.c, any size and any
+ * alignment of the array is allowed at any position of the sequence;
+ * gen_rand_array() is used for the part which starts at a 16-byte
+ * aligned address and is at least the size of the state table.
+ *
+ * @param sfmt the generator
+ * @param array an array where pseudorandom 32-bit integers are filled
+ * by this function.
+ * @param size the number of 32-bit pseudorandom integers to be
+ * generated.
+ */
+void sfmt_fill_array32(sfmt_t *sfmt, uint32_t *array, int size) {
+    int n32 = sfmt->n32;
+    int count;
+
+    while (size > 0) {
+	if (sfmt->idx >= n32) {
+	    if (size >= n32 && ((uintptr_t)array & 15) == 0) {
+		count = size & ~3;
+		sfmt->params->gen_rand_array((w128_t *)array, count / 4,
+					     sfmt->state);
+		array += count;
+		size -= count;
+		continue;
+	    }
+	    sfmt->params->gen_rand_all(sfmt->state);
+	    sfmt->idx = 0;
+	}
+	count = n32 - sfmt->idx;
+	if (count > size) {
+	    count = size;
+	}
+	memcpy(array, &sfmt->state32[sfmt->idx], sizeof(uint32_t) * count);
+	sfmt->idx += count;
+	array += count;
+	size -= count;
+    }
+}
+
+/**
+ * This function generates pseudorandom 64-bit integers in the
+ * specified array[] by one call, continuing the sequence of
+ * sfmt_next64() and sfmt_next32() at any position, even or odd, of the
+ * 32-bit sequence.
+ *
+ * @param sfmt the generator
+ * @param array an array where pseudorandom 64-bit integers are filled
+ * by this function.
+ * @param size the number of 64-bit pseudorandom integers to be
+ * generated.
+ */
+void sfmt_fill_array64(sfmt_t *sfmt, uint64_t *array, int size) {
+    sfmt_fill_array32(sfmt, (uint32_t *)array, size * 2);
+#if defined(BIG_ENDIAN64)
+    {
+	int i;
+
+	for (i = 0; i < size; i++) {
+	    array[i] = (array[i] << 32) | (array[i] >> 32);
+	}
+    }
+#endif
+}
+
+/**
+ * This function generates pseudorandom doubles in [0, 1) in the
+ * specified array[] by one call, the same sequence as that of
+ * sfmt_next_double().  While at least a state table of doubles is
+ * left, gen_rand_all_double() converts the new table in the same pass
+ * as the recursion, if the cursor is even; the rest is converted one by
+ * one.
+ *
+ * @param sfmt the generator
+ * @param array an array where doubles are filled by this function.
+ * @param size the number of doubles to be generated.
+ */
+void sfmt_fill_array_double(sfmt_t *sfmt, double *array, int size) {
+    int n64 = sfmt->n32 / 2;
+
+    while (size > 0) {
+	if (sfmt->idx == sfmt->n32 && size >= n64) {
+	    sfmt->params->gen_rand_all_double(sfmt->state, array);
+	    array += n64;
+	    size -= n64;
+	} else {
+	    *array++ = sfmt_next_double(sfmt);
+	    size--;
+	}
+    }
+}
+
+/**
+ * This function generates pseudorandom floats in [0, 1) in the
+ * specified array[] by one call, the same sequence as that of
+ * sfmt_next_float().  While at least a state table of floats is left,
+ * gen_rand_all_float() converts the new table in the same pass as the
+ * recursion; the rest is converted one by one.
+ *
+ * @param sfmt the generator
+ * @param array an array where floats are filled by this function.
+ * @param size the number of floats to be generated.
+ */
+void sfmt_fill_array_float(sfmt_t *sfmt, float *array, int size) {
+    int n32 = sfmt->n32;
+
+    while (size > 0) {
+	if (sfmt->idx >= n32 && size >= n32) {
+	    sfmt->params->gen_rand_all_float(sfmt->state, array);
+	    array += n32;
+	    size -= n32;
+	} else {
+	    *array++ = sfmt_next_float(sfmt);
+	    size--;
+	}
+    }
+}
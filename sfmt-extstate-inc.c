@@ -0,0 +1,407 @@
+/* This file is a part of sfmt-extstate */
+
+/**
+ * @file  sfmt-extstate-inc.c
+ * @brief incremental generators, refilling a slice at a time
+ *
+ * @author Kenji Rikitake
+ *
+ * Copyright (C) 2010 Kenji Rikitake. All rights reserved.
+ *
+ * The new BSD License is applied to this software, see LICENSE.txt
+ *
+ * @note sfmt_next32() of a generator calls gen_rand_all() once every
+ * 4N outputs, and that call takes as long as 4N of the others.  An
+ * incremental generator keeps the next state table besides the one
+ * being read, and makes a slice of it, of 1 to N 128-bit integers, by
+ * gen_rand_slice() every 4 slice outputs, so that the next table is
+ * complete when the current one has been read and the two are swapped.
+ * The recursion reads the current table only, which is therefore read
+ * as it is; the output is the same as that of sfmt_next32(), and the
+ * longest call makes a slice instead of N 128-bit integers.  Smaller
+ * slices make shorter longest calls and cost more calls of
+ * gen_rand_slice() in all.
+ *
+ * With a watermark, nothing is made while reading: when the reader
+ * passes the watermark, the next table is queued to a helper thread,
+ * which serves any number of generators in turn, or is left to the
+ * caller, who makes it by sfmt_inc_idle() when idle.  What is not made
+ * by the end of the table is made by the reader before the swap, so
+ * the output is the same in all the modes, and the memory stays at two
+ * tables a generator.
+ */
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <sched.h>
+#include "sfmt-extstate.h"
+
+/** the states of the request of the next table to the helper */
+enum {
+    /** not requested, or done and seen by the reader */
+    JOB_NONE,
+    /** in the queue of the helper */
+    JOB_QUEUED,
+    /** being made by the helper */
+    JOB_RUNNING,
+    /** made by the helper */
+    JOB_DONE
+};
+
+/** a helper thread making the next state tables of generators */
+struct SFMT_HELPER_T {
+    /** the thread */
+    pthread_t thread;
+    /** the lock of the members below and of the queue links */
+    pthread_mutex_t lock;
+    /** signaled when a generator is queued or the helper should exit */
+    pthread_cond_t cond;
+    /** the first and the last generators of the queue */
+    sfmt_inc_t *head, *tail;
+    /** set while the helper sleeps */
+    int sleeping;
+    /** set when the helper should exit */
+    int quit;
+};
+
+/* static function prototypes */
+static void request(sfmt_inc_t *inc);
+static void settle(sfmt_inc_t *inc);
+static void *help(void *arg);
+
+/**
+ * This function queues the next table of a generator to its helper.
+ * @param inc the incremental generator
+ */
+static void request(sfmt_inc_t *inc) {
+    sfmt_helper *helper = inc->helper;
+
+    pthread_mutex_lock(&helper->lock);
+    inc->queue_prev = helper->tail;
+    inc->queue_next = NULL;
+    if (helper->tail != NULL) {
+	helper->tail->queue_next = inc;
+    } else {
+	helper->head = inc;
+    }
+    helper->tail = inc;
+    __atomic_store_n(&inc->job, JOB_QUEUED, __ATOMIC_RELAXED);
+    if (helper->sleeping) {
+	pthread_cond_signal(&helper->cond);
+    }
+    pthread_mutex_unlock(&helper->lock);
+}
+
+/**
+ * This function takes back the request of the next table of a
+ * generator if the helper has not started it, or waits for the helper
+ * to finish it, so that the helper does not use the generator after
+ * this.
+ * @param inc the incremental generator
+ */
+static void settle(sfmt_inc_t *inc) {
+    sfmt_helper *helper = inc->helper;
+
+    if (helper == NULL) {
+	return;
+    }
+    if (__atomic_load_n(&inc->job, __ATOMIC_ACQUIRE) == JOB_QUEUED) {
+	pthread_mutex_lock(&helper->lock);
+	if (__atomic_load_n(&inc->job, __ATOMIC_RELAXED) == JOB_QUEUED) {
+	    if (inc->queue_prev != NULL) {
+		inc->queue_prev->queue_next = inc->queue_next;
+	    } else {
+		helper->head = inc->queue_next;
+	    }
+	    if (inc->queue_next != NULL) {
+		inc->queue_next->queue_prev = inc->queue_prev;
+	    } else {
+		helper->tail = inc->queue_prev;
+	    }
+	    __atomic_store_n(&inc->job, JOB_NONE, __ATOMIC_RELAXED);
+	}
+	pthread_mutex_unlock(&helper->lock);
+    }
+    while (__atomic_load_n(&inc->job, __ATOMIC_ACQUIRE) == JOB_RUNNING) {
+	sched_yield();
+    }
+    __atomic_store_n(&inc->job, JOB_NONE, __ATOMIC_RELAXED);
+}
+
+/**
+ * This function is the body of a helper thread, which makes the next
+ * tables of the queued generators in turn.
+ * @param arg the helper
+ * @return NULL
+ */
+static void *help(void *arg) {
+    sfmt_helper *helper = arg;
+    sfmt_inc_t *inc;
+
+    pthread_mutex_lock(&helper->lock);
+    for (;;) {
+	while (!helper->quit && helper->head == NULL) {
+	    helper->sleeping = 1;
+	    pthread_cond_wait(&helper->cond, &helper->lock);
+	    helper->sleeping = 0;
+	}
+	if (helper->quit) {
+	    break;
+	}
+	inc = helper->head;
+	helper->head = inc->queue_next;
+	if (helper->head != NULL) {
+	    helper->head->queue_prev = NULL;
+	} else {
+	    helper->tail = NULL;
+	}
+	__atomic_store_n(&inc->job, JOB_RUNNING, __ATOMIC_RELAXED);
+	pthread_mutex_unlock(&helper->lock);
+	inc->params->gen_rand_slice(inc->next, inc->state, inc->made,
+				    inc->params->n - inc->made);
+	inc->made = inc->params->n;
+	__atomic_store_n(&inc->job, JOB_DONE, __ATOMIC_RELEASE);
+	pthread_mutex_lock(&helper->lock);
+    }
+    pthread_mutex_unlock(&helper->lock);
+    return NULL;
+}
+
+/**
+ * This function allocates an incremental generator which goes on from
+ * the next output of a generator, and makes its next state table at
+ * once.  The generator is not changed.
+ * @param sfmt the generator, initialized
+ * @param slice the number of the 128-bit integers made every 4 slice
+ * outputs, 1 to N; e.g. 1 for the shortest longest call, 4 for a
+ * balance with the throughput
+ * @return the incremental generator, or NULL if slice is out of range
+ * or no memory
+ */
+sfmt_inc_t *sfmt_new_inc(const sfmt_t *sfmt, int slice) {
+    int n = sfmt->params->n;
+    void *tables;
+    sfmt_inc_t *inc;
+
+    if (slice < 1 || slice > n) {
+	return NULL;
+    }
+    inc = malloc(sizeof(sfmt_inc_t));
+    if (inc == NULL) {
+	return NULL;
+    }
+    if (posix_memalign(&tables, 64, sizeof(w128_t) * n * 2) != 0) {
+	free(inc);
+	return NULL;
+    }
+    inc->state = tables;
+    inc->state32 = &inc->state[0].u[0];
+    inc->next = inc->state + n;
+    memcpy(inc->state, sfmt->state, sizeof(w128_t) * n);
+    sfmt->params->gen_rand_slice(inc->next, inc->state, 0, n);
+    inc->idx = sfmt->idx;
+    inc->made = n;
+    inc->n32 = sfmt->n32;
+    inc->params = sfmt->params;
+    inc->slice = slice;
+    inc->mark = inc->idx < inc->n32 ? inc->idx : inc->n32;
+    inc->watermark = -1;
+    inc->helper = NULL;
+    inc->job = JOB_NONE;
+    inc->queue_prev = NULL;
+    inc->queue_next = NULL;
+    return inc;
+}
+
+/**
+ * This function frees an incremental generator, after taking it out of
+ * the queue of its helper.
+ * @param inc the incremental generator, or NULL
+ */
+void sfmt_free_inc(sfmt_inc_t *inc) {
+    if (inc == NULL) {
+	return;
+    }
+    settle(inc);
+    free(inc->state < inc->next ? inc->state : inc->next);
+    free(inc);
+}
+
+/**
+ * This function sets when and by whom the next state tables of an
+ * incremental generator are made.  With a watermark of -1, they are
+ * made by the reader a slice at a time, as after sfmt_new_inc().  With
+ * a watermark of 0 or more, they are made when the index of the next
+ * 32-bit output reaches the watermark, by the helper if given or by
+ * sfmt_inc_idle() otherwise, and by the reader at the end of the table
+ * as far as they are not made then.
+ * @param inc the incremental generator
+ * @param watermark -1, or the index of a 32-bit output of a table
+ * @param helper the helper thread, or NULL
+ * @return 0, or -1 if the watermark is out of range or a helper is
+ * given without a watermark
+ */
+int sfmt_inc_set_watermark(sfmt_inc_t *inc, int watermark,
+			   sfmt_helper *helper) {
+    if (watermark < -1 || watermark >= inc->n32
+	|| (watermark < 0 && helper != NULL)) {
+	return -1;
+    }
+    settle(inc);
+    if (watermark < 0 && inc->watermark >= 0 && inc->made < inc->params->n) {
+	/* the slices would not catch up with the reader */
+	inc->params->gen_rand_slice(inc->next, inc->state, inc->made,
+				    inc->params->n - inc->made);
+	inc->made = inc->params->n;
+    }
+    inc->watermark = watermark;
+    inc->helper = helper;
+    /* the next output refills, in the new mode */
+    inc->mark = inc->idx < inc->n32 ? inc->idx : inc->n32;
+    return 0;
+}
+
+/**
+ * This function makes up to size 128-bit integers of the next state
+ * table of an incremental generator with a watermark and no helper,
+ * once the reader has passed the watermark.  A caller with many
+ * generators calls this for them in turn when it has time.
+ * @param inc the incremental generator
+ * @param size the most 128-bit integers to make
+ * @return the number of the 128-bit integers of the next table left to
+ * make, or 0 if the watermark is not passed yet or the table is not
+ * made by sfmt_inc_idle()
+ */
+int sfmt_inc_idle(sfmt_inc_t *inc, int size) {
+    int n = inc->params->n;
+
+    if (inc->watermark < 0 || inc->helper != NULL
+	|| inc->idx < inc->watermark) {
+	return 0;
+    }
+    if (size > n - inc->made) {
+	size = n - inc->made;
+    }
+    if (size > 0) {
+	inc->params->gen_rand_slice(inc->next, inc->state, inc->made, size);
+	inc->made += size;
+    }
+    return n - inc->made;
+}
+
+/**
+ * This function swaps the state tables of an incremental generator at
+ * the end of the current one, and makes the next slice of the next
+ * table, or requests the next table at the watermark.  This is called
+ * by sfmt_inc_next32() every 4 slice outputs, or at the watermark and
+ * at the end of the table.
+ * @param inc the incremental generator
+ */
+void sfmt_inc_refill(sfmt_inc_t *inc) {
+    int n = inc->params->n;
+    int size;
+    w128_t *t;
+
+    if (inc->idx >= inc->n32) {
+	if (inc->watermark >= 0) {
+	    settle(inc);
+	    if (inc->made < n) {
+		inc->params->gen_rand_slice(inc->next, inc->state, inc->made,
+					    n - inc->made);
+	    }
+	}
+	/* all of next is made by now, a slice every 4 slice of the 4N
+	   outputs from the last swap without a watermark */
+	t = inc->state;
+	inc->state = inc->next;
+	inc->next = t;
+	inc->state32 = &inc->state[0].u[0];
+	inc->idx = 0;
+	inc->made = 0;
+	if (inc->watermark < 0) {
+	    /* the first slice by the next call, not to make this longer */
+	    inc->mark = 1;
+	    return;
+	}
+    }
+    if (inc->watermark < 0) {
+	size = n - inc->made < inc->slice ? n - inc->made : inc->slice;
+	if (size > 0) {
+	    inc->params->gen_rand_slice(inc->next, inc->state, inc->made,
+					size);
+	    inc->made += size;
+	}
+	inc->mark = inc->idx + inc->slice * 4 < inc->n32
+	    ? inc->idx + inc->slice * 4 : inc->n32;
+    } else if (inc->idx < inc->watermark) {
+	inc->mark = inc->watermark;
+    } else {
+	if (inc->helper != NULL
+	    && __atomic_load_n(&inc->job, __ATOMIC_ACQUIRE) == JOB_NONE
+	    && inc->made < n) {
+	    request(inc);
+	}
+	inc->mark = inc->n32;
+    }
+}
+
+/**
+ * This function starts a helper thread, which makes the next state
+ * tables of the incremental generators given it by
+ * sfmt_inc_set_watermark() in the order they pass their watermarks.
+ * @param cpu the CPU the thread is pinned to, or -1; ignored but on
+ * Linux
+ * @return the helper, or NULL if no memory or no thread
+ */
+sfmt_helper *sfmt_new_helper(int cpu) {
+    sfmt_helper *helper;
+    pthread_attr_t attr;
+#if defined(__linux__)
+    cpu_set_t set;
+#endif
+    int error;
+
+    helper = calloc(1, sizeof(sfmt_helper));
+    if (helper == NULL) {
+	return NULL;
+    }
+    pthread_mutex_init(&helper->lock, NULL);
+    pthread_cond_init(&helper->cond, NULL);
+    pthread_attr_init(&attr);
+#if defined(__linux__)
+    if (cpu >= 0) {
+	CPU_ZERO(&set);
+	CPU_SET(cpu, &set);
+	pthread_attr_setaffinity_np(&attr, sizeof(set), &set);
+    }
+#endif
+    error = pthread_create(&helper->thread, &attr, help, helper);
+    pthread_attr_destroy(&attr);
+    if (error != 0) {
+	pthread_cond_destroy(&helper->cond);
+	pthread_mutex_destroy(&helper->lock);
+	free(helper);
+	return NULL;
+    }
+    return helper;
+}
+
+/**
+ * This function stops a helper thread and frees it.  The generators
+ * given it must be freed or given another helper before.
+ * @param helper the helper, or NULL
+ */
+void sfmt_free_helper(sfmt_helper *helper) {
+    if (helper == NULL) {
+	return;
+    }
+    pthread_mutex_lock(&helper->lock);
+    helper->quit = 1;
+    pthread_cond_broadcast(&helper->cond);
+    pthread_mutex_unlock(&helper->lock);
+    pthread_join(helper->thread, NULL);
+    pthread_cond_destroy(&helper->cond);
+    pthread_mutex_destroy(&helper->lock);
+    free(helper);
+}
@@ -0,0 +1,289 @@
+/* This file is a part of sfmt-extstate */
+
+/**
+ * @file  sfmt-extstate-index.c
+ * @brief checkpoint indexes of long streams for random access
+ *
+ * @author Kenji Rikitake
+ *
+ * Copyright (C) 2010 Kenji Rikitake. All rights reserved.
+ *
+ * The new BSD License is applied to this software, see LICENSE.txt
+ *
+ * @note The block b of a stream is the state table after b + 1 calls
+ * of gen_rand_all() from its origin, the 32-bit outputs 4N b to 4N (b
+ * + 1) - 1 of a generator started there.  An index keeps the state
+ * tables before the blocks 0, 2^k, 2 * 2^k, ..., the checkpoints, with
+ * the smallest k which fits a memory budget, and makes a block again
+ * from the checkpoint before it by at most 2^k calls of gen_rand_all(),
+ * or by the jumps of a jump table if they are cheaper or the block is
+ * past the end of the index.  An index file is the header below and
+ * the checkpoints, which are used in place when the file is mapped, so
+ * that many processes share one copy.
+ */
+#define _POSIX_C_SOURCE 200112L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "sfmt-extstate.h"
+
+/** the magic number of an index file */
+#define INDEX_MAGIC "SFMTINDX"
+/** the version of the index files, also a byte order mark */
+#define INDEX_VERSION 1
+
+/**
+ * the header of an index file, followed by count state tables of n
+ * 128-bit integers, all in the byte order of the writer
+ */
+struct INDEX_HEADER_T {
+    /** INDEX_MAGIC */
+    char magic[8];
+    /** INDEX_VERSION */
+    uint32_t version;
+    /** Mersenne exponent */
+    uint32_t mexp;
+    /** the checkpoints are 2^k blocks apart */
+    uint32_t k;
+    /** size of a state table in 128-bit integers, N */
+    uint32_t n;
+    /** the number of the checkpoints */
+    uint64_t count;
+    /** the number of the blocks of the stream */
+    uint64_t blocks;
+    /** the identification string of the parameter set, NUL padded */
+    char idstr[88];
+};
+/** the header of an index file */
+typedef struct INDEX_HEADER_T index_header;
+
+/**
+ * This function makes an index of a stream by generating its blocks
+ * from the origin, with the checkpoints as close as the memory budget
+ * allows.
+ * @param mexp Mersenne exponent, one of SFMT_MEXP_LIST
+ * @param origin internal state array of the parameter set, the start
+ * of the stream
+ * @param blocks the number of the blocks of the stream, at least 1
+ * @param budget the maximum size of the checkpoints in bytes, at least
+ * that of a state table
+ * @return the index, or NULL if mexp is not supported, blocks is 0,
+ * the budget is too small or no memory
+ */
+sfmt_index *sfmt_new_index(int mexp, const w128_t *origin, uint64_t blocks,
+			   size_t budget) {
+    int k;
+    uint64_t b, c, count;
+    size_t bytes;
+    void *states;
+    w128_t *state;
+    sfmt_index *index;
+    const sfmt_params_t *params = sfmt_get_params(mexp);
+
+    if (params == NULL || blocks == 0) {
+	return NULL;
+    }
+    bytes = sizeof(w128_t) * params->n;
+    for (k = 0; k < 64; k++) {
+	count = ((blocks - 1) >> k) + 1;
+	if (count <= budget / bytes) {
+	    break;
+	}
+    }
+    if (k == 64) {
+	return NULL;
+    }
+    index = malloc(sizeof(sfmt_index));
+    if (index == NULL) {
+	return NULL;
+    }
+    if (posix_memalign(&states, 64, bytes * count) != 0) {
+	free(index);
+	return NULL;
+    }
+    /* the checkpoint c is before the block c * 2^k */
+    state = states;
+    memcpy(state, origin, bytes);
+    for (c = 1; c < count; c++) {
+	memcpy(state + params->n, state, bytes);
+	state += params->n;
+	for (b = 0; b < ((uint64_t)1 << k); b++) {
+	    params->gen_rand_all(state);
+	}
+    }
+    index->params = params;
+    index->k = k;
+    index->count = count;
+    index->blocks = blocks;
+    index->map = NULL;
+    index->size = 0;
+    index->states = states;
+    return index;
+}
+
+/**
+ * This function writes an index to a file.
+ * @param index the index
+ * @param path the file name
+ * @return 0, or -1 if the identification string is too long or an I/O
+ * error
+ */
+int sfmt_save_index(const sfmt_index *index, const char *path) {
+    FILE *fp;
+    index_header header;
+
+    if (strlen(index->params->idstr) >= sizeof(header.idstr)) {
+	return -1;
+    }
+    fp = fopen(path, "wb");
+    if (fp == NULL) {
+	return -1;
+    }
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, INDEX_MAGIC, sizeof(header.magic));
+    header.version = INDEX_VERSION;
+    header.mexp = index->params->mexp;
+    header.k = index->k;
+    header.n = index->params->n;
+    header.count = index->count;
+    header.blocks = index->blocks;
+    strcpy(header.idstr, index->params->idstr);
+    fwrite(&header, sizeof(header), 1, fp);
+    fwrite(index->states, sizeof(w128_t) * index->params->n,
+	   (size_t)index->count, fp);
+    if (ferror(fp)) {
+	fclose(fp);
+	return -1;
+    }
+    return fclose(fp) == 0 ? 0 : -1;
+}
+
+/**
+ * This function maps an index file of sfmt_save_index() read-only.
+ * The checkpoints are used in place, so the file is shared by the
+ * processes which map it.
+ * @param path the file name
+ * @param mexp Mersenne exponent, one of SFMT_MEXP_LIST
+ * @return the index, or NULL if mexp is not supported, the file is
+ * not an index of the parameter set of mexp in the byte order of this
+ * machine, or no memory
+ */
+sfmt_index *sfmt_open_index(const char *path, int mexp) {
+    int fd;
+    struct stat st;
+    void *map;
+    size_t bytes;
+    const index_header *header;
+    sfmt_index *index;
+    const sfmt_params_t *params = sfmt_get_params(mexp);
+
+    if (params == NULL) {
+	return NULL;
+    }
+    fd = open(path, O_RDONLY);
+    if (fd < 0) {
+	return NULL;
+    }
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(*header)) {
+	close(fd);
+	return NULL;
+    }
+    map = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+	return NULL;
+    }
+    header = map;
+    bytes = sizeof(w128_t) * params->n;
+    if (memcmp(header->magic, INDEX_MAGIC, sizeof(header->magic)) != 0
+	|| header->version != INDEX_VERSION
+	|| header->mexp != (uint32_t)mexp
+	|| header->n != (uint32_t)params->n
+	|| header->k >= 64 || header->count == 0 || header->blocks == 0
+	|| header->count != ((header->blocks - 1) >> header->k) + 1
+	|| strncmp(header->idstr, params->idstr, sizeof(header->idstr)) != 0
+	|| ((size_t)st.st_size - sizeof(*header)) / bytes != header->count
+	|| ((size_t)st.st_size - sizeof(*header)) % bytes != 0) {
+	munmap(map, st.st_size);
+	return NULL;
+    }
+    index = malloc(sizeof(sfmt_index));
+    if (index == NULL) {
+	munmap(map, st.st_size);
+	return NULL;
+    }
+    index->params = params;
+    index->k = header->k;
+    index->count = header->count;
+    index->blocks = header->blocks;
+    index->map = map;
+    index->size = st.st_size;
+    index->states = (const w128_t *)(header + 1);
+    return index;
+}
+
+/**
+ * This function frees an index of sfmt_new_index(), or unmaps one of
+ * sfmt_open_index().
+ * @param index the index, or NULL
+ */
+void sfmt_free_index(sfmt_index *index) {
+    if (index == NULL) {
+	return;
+    }
+    if (index->map != NULL) {
+	munmap(index->map, index->size);
+    } else {
+	free((void *)index->states);
+    }
+    free(index);
+}
+
+/**
+ * This function makes a block of the stream of an index again, from
+ * the checkpoint before it by gen_rand_all(), or by the jumps of a
+ * table if there are more than 128N blocks to skip.  A block past the
+ * end of the index is made from the last checkpoint and needs a table,
+ * even if it is near enough to be made by gen_rand_all().
+ * @param index the index
+ * @param table the jump table of the parameter set of index, with 2^k
+ * for k = 0 up to the bits of the skip, or NULL
+ * @param b the block
+ * @param block internal state array of the parameter set of index,
+ * where the block is stored
+ * @return 0, or -1 if the block is past the end and table is NULL, the
+ * table is of another parameter set or lacks a polynomial, or no
+ * memory
+ */
+int sfmt_index_block(const sfmt_index *index, const sfmt_jump_table *table,
+		     uint64_t b, w128_t *block) {
+    int n = index->params->n;
+    uint64_t c = b >> index->k;
+    uint64_t d;
+
+    if (c >= index->count) {
+	c = index->count - 1;
+    }
+    /* the block is d + 1 calls of gen_rand_all() after the checkpoint */
+    d = b - (c << index->k);
+    if ((table == NULL && b >= index->blocks)
+	|| (table != NULL && table->params != index->params)) {
+	return -1;
+    }
+    memcpy(block, index->states + (size_t)c * n, sizeof(w128_t) * n);
+    if (table != NULL && d >= (uint64_t)128 * n) {
+	if (sfmt_jump_substream(block, table, 0, d * n) != 0) {
+	    return -1;
+	}
+    } else {
+	for (; d > 0; d--) {
+	    index->params->gen_rand_all(block);
+	}
+    }
+    index->params->gen_rand_all(block);
+    return 0;
+}
@@ -0,0 +1,990 @@
+/* This file is a part of sfmt-extstate */
+
+/**
+ * @file  sfmt-extstate-jump.c
+ * @brief jump-ahead of the state tables by polynomial arithmetic
+ *
+ * @author Kenji Rikitake
+ *
+ * Copyright (C) 2010 Kenji Rikitake. All rights reserved.
+ *
+ * The new BSD License is applied to this software, see LICENSE.txt
+ *
+ * @note The 128-bit integers s[0], s[1], ... of SFMT, of which a state
+ * table holds N consecutive ones, follow a linear recursion over
+ * GF(2), and so are annihilated by its minimal polynomial m(x) =
+ * m[0] + m[1] x + ... + x^d: sum m[i] s[k + i] = 0 for all k.  If
+ * q(x) = x^J mod m(x), then s[k + J] = sum q[i] s[k + i], so a state
+ * table is moved J 128-bit integers ahead by adding up d + 1 tables
+ * of one-step moves (H. Haramoto, M. Matsumoto, T. Nishimura, F. Panneton
+ * and P. L'Ecuyer, "Efficient Jump Ahead for F2-Linear Random Number
+ * Generators", 2008).
+ *
+ * m(x) is found by the Berlekamp-Massey algorithm from bit sequences
+ * of 2 * 128N integers, and x^J mod m(x) by square-and-multiply.  Both
+ * take time in the square of d, up to 128N; sfmt_jump() itself takes
+ * time in d * N.  All the functions are generic over the parameter set
+ * descriptors.
+ */
+#define _POSIX_C_SOURCE 200112L
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "sfmt-extstate.h"
+
+/** the magic number of a jump table file */
+#define JUMP_TABLE_MAGIC "SFMTJUMP"
+/** the version of the jump table files, also a byte order mark */
+#define JUMP_TABLE_VERSION 1
+
+/**
+ * the header of a jump table file, followed by count 64-bit degrees
+ * and count polynomials of words 64-bit integers, all in the byte
+ * order of the writer
+ */
+struct JUMP_TABLE_HEADER_T {
+    /** JUMP_TABLE_MAGIC */
+    char magic[8];
+    /** JUMP_TABLE_VERSION */
+    uint32_t version;
+    /** Mersenne exponent */
+    uint32_t mexp;
+    /** the first polynomial is that of 2^kmin */
+    uint32_t kmin;
+    /** the number of the polynomials, of 2^kmin, 2^(kmin + 1), ... */
+    uint32_t count;
+    /** size of a polynomial in 64-bit integers, 2N */
+    uint32_t words;
+    /** reserved, 0 */
+    uint32_t reserved;
+    /** the identification string of the parameter set, NUL padded */
+    char idstr[96];
+};
+/** the header of a jump table file */
+typedef struct JUMP_TABLE_HEADER_T jump_table_header;
+
+/* static function prototypes */
+static void do_recursion(const sfmt_params_t *params, w128_t *r,
+			 const w128_t *a, const w128_t *b, const w128_t *c,
+			 const w128_t *d);
+static void add_window(w128_t *work, const w128_t *win, int p, int n);
+static void xor_shifted(uint64_t *dst, const uint64_t *src, int words,
+			int shift);
+static void apply_poly(const sfmt_params_t *params, w128_t *intstate,
+		       const uint64_t *coef, int degree, w128_t *work);
+static int berlekamp_massey(const uint64_t *seq, int length, uint64_t *poly,
+			    int words);
+static void init_table(const sfmt_params_t *params, uint32_t seed,
+		       w128_t *state);
+static void next_table(const sfmt_params_t *params, w128_t *state);
+static void sqr_mod(uint64_t *r, const uint64_t *m, int d, int words, int e);
+static void pow_mod(uint64_t *r, const uint64_t *m, int d, int words,
+		    const uint32_t *step, int step_length);
+static int poly_degree(const uint64_t *coef, int words);
+static int check_substream(const sfmt_params_t *params, int stride,
+			   uint64_t count, uint64_t i);
+
+/**
+ * This function represents the recursion formula of a parameter set.
+ * @param params the parameter set
+ * @param r output
+ * @param a a 128-bit part of the internal state array
+ * @param b a 128-bit part of the internal state array
+ * @param c a 128-bit part of the internal state array
+ * @param d a 128-bit part of the internal state array
+ */
+static void do_recursion(const sfmt_params_t *params, w128_t *r,
+			 const w128_t *a, const w128_t *b, const w128_t *c,
+			 const w128_t *d) {
+    int i;
+    uint64_t ah, al, ch, cl, xh, xl, yh, yl;
+    uint32_t x[4], y[4];
+    int sl2 = params->sl2 * 8;
+    int sr2 = params->sr2 * 8;
+
+    ah = ((uint64_t)a->u[3] << 32) | a->u[2];
+    al = ((uint64_t)a->u[1] << 32) | a->u[0];
+    ch = ((uint64_t)c->u[3] << 32) | c->u[2];
+    cl = ((uint64_t)c->u[1] << 32) | c->u[0];
+    xh = (ah << sl2) | (al >> (64 - sl2));
+    xl = al << sl2;
+    yl = (cl >> sr2) | (ch << (64 - sr2));
+    yh = ch >> sr2;
+    x[0] = (uint32_t)xl;
+    x[1] = (uint32_t)(xl >> 32);
+    x[2] = (uint32_t)xh;
+    x[3] = (uint32_t)(xh >> 32);
+    y[0] = (uint32_t)yl;
+    y[1] = (uint32_t)(yl >> 32);
+    y[2] = (uint32_t)yh;
+    y[3] = (uint32_t)(yh >> 32);
+    for (i = 0; i < 4; i++) {
+	r->u[i] = a->u[i] ^ x[i] ^ ((b->u[i] >> params->sr1) & params->msk[i])
+	    ^ y[i] ^ (d->u[i] << params->sl1);
+    }
+}
+
+/**
+ * This function adds a window of a circular table into a table.
+ * @param work the table added to
+ * @param win the circular table
+ * @param p the position of the first integer of the window in win
+ * @param n size of the tables in 128-bit integers
+ */
+static void add_window(w128_t *work, const w128_t *win, int p, int n) {
+    int i;
+
+#if defined(HAVE_SSE2)
+    for (i = 0; i < n - p; i++) {
+	work[i].si = _mm_xor_si128(work[i].si, win[p + i].si);
+    }
+    for (; i < n; i++) {
+	work[i].si = _mm_xor_si128(work[i].si, win[p + i - n].si);
+    }
+#else
+    int j;
+
+    for (i = 0; i < n; i++) {
+	const w128_t *w = &win[p + i < n ? p + i : p + i - n];
+
+	for (j = 0; j < 4; j++) {
+	    work[i].u[j] ^= w->u[j];
+	}
+    }
+#endif
+}
+
+/**
+ * This function replaces a state table of s[0], ..., s[N - 1] with
+ * that of sum c[i] s[k + i] for k = 0, ..., N - 1, where c is a
+ * polynomial.
+ * @param params the parameter set
+ * @param intstate internal state array
+ * @param coef the polynomial c
+ * @param degree the degree of c
+ * @param work a table of N 128-bit integers
+ */
+static void apply_poly(const sfmt_params_t *params, w128_t *intstate,
+		       const uint64_t *coef, int degree, w128_t *work) {
+    int i, k;
+    int n = params->n;
+
+    memset(work, 0, sizeof(w128_t) * n);
+    /* intstate is the circular table of s[i], ..., s[i + N - 1],
+       starting at k = i mod N */
+    for (i = 0, k = 0; i <= degree; i++) {
+	if ((coef[i / 64] >> (i % 64)) & 1) {
+	    add_window(work, intstate, k, n);
+	}
+	do_recursion(params, &intstate[k], &intstate[k],
+		     &intstate[(k + params->pos1) % n],
+		     &intstate[(k + n - 2) % n], &intstate[(k + n - 1) % n]);
+	k = (k + 1 == n) ? 0 : k + 1;
+    }
+    memcpy(intstate, work, sizeof(w128_t) * n);
+}
+
+/**
+ * This function adds a polynomial multiplied by x^shift to another.
+ * @param dst the polynomial added to, long enough for the product
+ * @param src the polynomial added
+ * @param words size of src in 64-bit integers
+ * @param shift the power of x
+ */
+static void xor_shifted(uint64_t *dst, const uint64_t *src, int words,
+			int shift) {
+    int i;
+    int w = shift / 64;
+    int b = shift % 64;
+
+    if (b == 0) {
+	for (i = 0; i < words; i++) {
+	    dst[w + i] ^= src[i];
+	}
+	return;
+    }
+    for (i = 0; i < words; i++) {
+	dst[w + i] ^= src[i] << b;
+	dst[w + i + 1] ^= src[i] >> (64 - b);
+    }
+}
+
+/**
+ * This function finds the minimal polynomial of a bit sequence by the
+ * Berlekamp-Massey algorithm.
+ * @param seq the sequence, the bit i % 64 of seq[i / 64] being the i-th
+ * @param length the length of the sequence, twice the maximum degree
+ * @param poly the polynomial, words 64-bit integers
+ * @param words more than length / 128 64-bit integers
+ * @return the degree of the polynomial, or -1 if no memory
+ */
+static int berlekamp_massey(const uint64_t *seq, int length, uint64_t *poly,
+			    int words) {
+    int i, j, n, m, len;
+    uint64_t *reg, *c, *b, *t;
+    uint64_t carry, next, d;
+
+    reg = calloc(words * 4, sizeof(uint64_t));
+    if (reg == NULL) {
+	return -1;
+    }
+    c = reg + words;
+    b = c + words;
+    t = b + words;
+    /* c(x) = 1 + c[1] x + ... + c[len] x^len, with the bit i of reg
+       holding the bit n - i of the sequence */
+    c[0] = b[0] = 1;
+    len = 0;
+    m = -1;
+    for (n = 0; n < length; n++) {
+	carry = (seq[n / 64] >> (n % 64)) & 1;
+	d = 0;
+	for (j = 0; j < words; j++) {
+	    next = reg[j] >> 63;
+	    reg[j] = (reg[j] << 1) | carry;
+	    carry = next;
+	    d ^= reg[j] & c[j];
+	}
+	d ^= d >> 32;
+	d ^= d >> 16;
+	d ^= d >> 8;
+	d ^= d >> 4;
+	d ^= d >> 2;
+	d ^= d >> 1;
+	if ((d & 1) == 0) {
+	    continue;
+	}
+	if (2 * len <= n) {
+	    memcpy(t, c, sizeof(uint64_t) * words);
+	    xor_shifted(c, b, words - (n - m + 63) / 64, n - m);
+	    len = n + 1 - len;
+	    memcpy(b, t, sizeof(uint64_t) * words);
+	    m = n;
+	} else {
+	    xor_shifted(c, b, words - (n - m + 63) / 64, n - m);
+	}
+    }
+    /* the minimal polynomial is x^len c(1/x) */
+    memset(poly, 0, sizeof(uint64_t) * words);
+    for (i = 0; i <= len; i++) {
+	if ((c[i / 64] >> (i % 64)) & 1) {
+	    poly[(len - i) / 64] |= (uint64_t)1 << ((len - i) % 64);
+	}
+    }
+    free(reg);
+    return len;
+}
+
+/**
+ * This function initializes a state table with a seed as
+ * init_gen_rand() does, without the period certification, which is
+ * not needed to find the minimal polynomial.
+ * @param params the parameter set
+ * @param seed a 32-bit integer used as the seed
+ * @param state internal state array
+ */
+static void init_table(const sfmt_params_t *params, uint32_t seed,
+		       w128_t *state) {
+    int i;
+    uint32_t x = seed;
+
+    state[0].u[0] = x;
+    for (i = 1; i < params->n32; i++) {
+	x = 1812433253UL * (x ^ (x >> 30)) + i;
+	state[i / 4].u[i % 4] = x;
+    }
+}
+
+/**
+ * This function fills a state table with the next N 128-bit integers,
+ * as gen_rand_all() does.
+ * @param params the parameter set
+ * @param state internal state array
+ */
+static void next_table(const sfmt_params_t *params, w128_t *state) {
+    int i;
+    int n = params->n;
+
+    for (i = 0; i < n; i++) {
+	do_recursion(params, &state[i], &state[i],
+		     &state[(i + params->pos1) % n],
+		     &state[(i + n - 2) % n], &state[(i + n - 1) % n]);
+    }
+}
+
+/**
+ * This function finds a polynomial which annihilates the 128-bit
+ * integer sequences of a parameter set, the minimal polynomial of the
+ * recursion if the seeds are general enough; it is the characteristic
+ * polynomial of degree 128N for all the parameter sets of the library.
+ * A bit of a sequence may miss some factors of the polynomial of the
+ * 128-bit integers; they are found in the sequence left nonzero by the
+ * factors found so far.  Only the parameters of params are used, not
+ * the functions, so that params may be of a parameter set outside the
+ * library.
+ * @param params the parameter set
+ * @param poly the polynomial, the coefficient of x^i in the bit i % 64
+ * of poly[i / 64], 2 * params->n + 1 64-bit integers
+ * @return the degree 128N of the polynomial, -1 if no memory, or -2 if
+ * the polynomial found is of lower degree, as it is if the sequences of
+ * the seeds miss a factor of the characteristic polynomial; jump
+ * polynomials modulo it would be wrong for the states outside them
+ */
+int sfmt_min_poly(const sfmt_params_t *params, uint64_t *poly) {
+    int i, j, k, n;
+    int d, e;
+    int n128 = params->n * 128;
+    int words = params->n * 2 + 1;
+    uint32_t x;
+    uint64_t *seq, *g, *t;
+    w128_t *state, *work;
+    void *p;
+    static const uint32_t seeds[] = {4357, 1, 2, 3, 5, 8, 13, 21};
+
+    if (posix_memalign(&p, 16, sizeof(w128_t) * params->n * 2) != 0) {
+	return -1;
+    }
+    state = p;
+    work = state + params->n;
+    seq = malloc(sizeof(uint64_t) * (n128 * 2 / 64 + words * 2));
+    if (seq == NULL) {
+	free(state);
+	return -1;
+    }
+    g = seq + n128 * 2 / 64;
+    t = g + words;
+    memset(poly, 0, sizeof(uint64_t) * words);
+    poly[0] = 1;
+    d = 0;
+    for (k = 0; k < (int)(sizeof(seeds) / sizeof(seeds[0])); k++) {
+	for (;;) {
+	    init_table(params, seeds[k], state);
+	    apply_poly(params, state, poly, d, work);
+	    for (i = 0, x = 0; i < params->n * 4 && x == 0; i++) {
+		x = state[i / 4].u[i % 4];
+	    }
+	    if (x == 0) {
+		break;
+	    }
+	    /* a nonzero bit of the sequence left */
+	    j = (i - 1) % 4;
+	    for (e = 0; ((x >> e) & 1) == 0; e++) {
+	    }
+	    memset(seq, 0, sizeof(uint64_t) * n128 * 2 / 64);
+	    for (n = 0; n < n128 * 2; n += params->n) {
+		for (i = 0; i < params->n; i++) {
+		    seq[(n + i) / 64] |= (uint64_t)((state[i].u[j] >> e) & 1)
+			<< ((n + i) % 64);
+		}
+		next_table(params, state);
+	    }
+	    e = berlekamp_massey(seq, n128 * 2, g, words);
+	    if (e < 0) {
+		d = -1;
+		goto out;
+	    }
+	    if (e == 0 || d + e > n128) {
+		d = -2;
+		goto out;
+	    }
+	    /* poly = poly * g */
+	    memset(t, 0, sizeof(uint64_t) * words);
+	    for (i = 0; i <= e; i++) {
+		if ((g[i / 64] >> (i % 64)) & 1) {
+		    xor_shifted(t, poly, words - (i + 63) / 64, i);
+		}
+	    }
+	    memcpy(poly, t, sizeof(uint64_t) * words);
+	    d += e;
+	}
+    }
+    if (d != n128) {
+	d = -2;
+    }
+ out:
+    free(state);
+    free(seq);
+    return d;
+}
+
+/**
+ * This function calculates r^2 x^e modulo a polynomial.
+ * @param r the polynomial, less than m in degree, 2 * words 64-bit
+ * integers
+ * @param m the modulus
+ * @param d the degree of m, at least 1
+ * @param words size of m in 64-bit integers
+ * @param e 0 or 1
+ */
+static void sqr_mod(uint64_t *r, const uint64_t *m, int d, int words, int e) {
+    int j, k;
+    uint64_t v;
+
+    /* r = r^2: the bit j goes to the bit 2j */
+    for (j = words - 1; j >= 0; j--) {
+	for (k = 1; k >= 0; k--) {
+	    v = (uint32_t)(r[j] >> (32 * k));
+	    v = (v | (v << 16)) & 0x0000ffff0000ffffULL;
+	    v = (v | (v << 8)) & 0x00ff00ff00ff00ffULL;
+	    v = (v | (v << 4)) & 0x0f0f0f0f0f0f0f0fULL;
+	    v = (v | (v << 2)) & 0x3333333333333333ULL;
+	    v = (v | (v << 1)) & 0x5555555555555555ULL;
+	    r[2 * j + k] = v;
+	}
+    }
+    /* r = r * x */
+    if (e) {
+	for (j = words * 2 - 1; j > 0; j--) {
+	    r[j] = (r[j] << 1) | (r[j - 1] >> 63);
+	}
+	r[0] <<= 1;
+    }
+    /* r = r mod m */
+    for (j = 2 * d; j >= d; j--) {
+	if ((r[j / 64] >> (j % 64)) & 1) {
+	    xor_shifted(r, m, words, j - d);
+	}
+    }
+}
+
+/**
+ * This function calculates x^step modulo a polynomial by
+ * square-and-multiply.
+ * @param r the result, 2 * words 64-bit integers
+ * @param m the modulus
+ * @param d the degree of m, at least 1
+ * @param words size of m in 64-bit integers
+ * @param step the power of x, an array of 32-bit integers, the lowest
+ * first
+ * @param step_length the length of step
+ */
+static void pow_mod(uint64_t *r, const uint64_t *m, int d, int words,
+		    const uint32_t *step, int step_length) {
+    int i;
+
+    memset(r, 0, sizeof(uint64_t) * words * 2);
+    r[0] = 1;
+    for (i = step_length * 32 - 1; i >= 0; i--) {
+	sqr_mod(r, m, d, words, (step[i / 32] >> (i % 32)) & 1);
+    }
+}
+
+/**
+ * This function returns the degree of a polynomial.
+ * @param coef the polynomial
+ * @param words size of coef in 64-bit integers
+ * @return the degree, or 0 for the zero polynomial
+ */
+static int poly_degree(const uint64_t *coef, int words) {
+    int i;
+
+    for (i = words * 64 - 1; i > 0 && ((coef[i / 64] >> (i % 64)) & 1) == 0;
+	 i--) {
+    }
+    return i;
+}
+
+/**
+ * This function calculates the jump polynomial which moves a state
+ * table of a parameter set step 128-bit integers ahead, that is,
+ * which skips 4 * step 32-bit outputs; step = k N is the same as k
+ * calls of gen_rand_all().  This takes time in the square of 128N,
+ * e.g. 0.4 seconds for MEXP 19937 and 44 seconds for MEXP 216091 with
+ * a step of 2^64.
+ * @param mexp Mersenne exponent, one of SFMT_MEXP_LIST
+ * @param step the number of 128-bit integers, an array of 32-bit
+ * integers, the lowest first, e.g. {0, 0, 1} for 2^64
+ * @param step_length the length of step
+ * @return the jump polynomial, or NULL if mexp is not supported or no
+ * memory
+ */
+jump_poly *sfmt_new_jump_poly(int mexp, const uint32_t *step,
+			      int step_length) {
+    int d, i;
+    int words;
+    uint64_t *m, *r, *coef;
+    jump_poly *p;
+    const sfmt_params_t *params = sfmt_get_params(mexp);
+
+    if (params == NULL) {
+	return NULL;
+    }
+    words = params->n * 2 + 1;
+    m = malloc(sizeof(uint64_t) * words * 3);
+    if (m == NULL) {
+	return NULL;
+    }
+    r = m + words;
+    d = sfmt_min_poly(params, m);
+    if (d < 0) {
+	free(m);
+	return NULL;
+    }
+    pow_mod(r, m, d, words, step, step_length);
+    i = poly_degree(r, words);
+    p = malloc(sizeof(jump_poly) + sizeof(uint64_t) * (i / 64 + 1));
+    if (p == NULL) {
+	free(m);
+	return NULL;
+    }
+    coef = (uint64_t *)(p + 1);
+    memcpy(coef, r, sizeof(uint64_t) * (i / 64 + 1));
+    p->params = params;
+    p->degree = i;
+    p->coef = coef;
+    free(m);
+    return p;
+}
+
+/**
+ * This function frees a jump polynomial of sfmt_new_jump_poly().
+ * @param p the jump polynomial, or NULL
+ */
+void sfmt_free_jump_poly(jump_poly *p) {
+    free(p);
+}
+
+/**
+ * This function moves a state table ahead by a jump polynomial, in time
+ * in p->degree * N, e.g. 1 millisecond for MEXP 19937 and 0.2 seconds
+ * for MEXP 216091.  The outputs
+ * of gen_rand_all() after this are those after the skipped ones.
+ * @param intstate internal state array of the parameter set of p
+ * @param p the jump polynomial
+ * @return 0, or -1 if no memory; intstate is unchanged then
+ */
+int sfmt_jump(w128_t *intstate, const jump_poly *p) {
+    w128_t *work;
+    void *q;
+
+    if (posix_memalign(&q, 16, sizeof(w128_t) * p->params->n) != 0) {
+	return -1;
+    }
+    work = q;
+    apply_poly(p->params, intstate, p->coef, p->degree, work);
+    free(work);
+    return 0;
+}
+
+/**
+ * This function writes a jump table file of jump polynomials of a
+ * parameter set.
+ * @param path the file name
+ * @param params the parameter set
+ * @param kmin the power of 2 of the first polynomial
+ * @param count the number of the polynomials
+ * @param coef the polynomials of 2^kmin, ..., 2^(kmin + count - 1)
+ * 128-bit integers, each of 2 * params->n 64-bit integers
+ * @return 0, or -1 if the identification string is too long, no memory
+ * or an I/O error
+ */
+int sfmt_save_jump_table(const char *path, const sfmt_params_t *params,
+			 int kmin, int count, const uint64_t *coef) {
+    int i;
+    int words = params->n * 2;
+    uint64_t degree;
+    FILE *fp;
+    jump_table_header header;
+
+    if (kmin < 0 || count <= 0
+	|| strlen(params->idstr) >= sizeof(header.idstr)) {
+	return -1;
+    }
+    fp = fopen(path, "wb");
+    if (fp == NULL) {
+	return -1;
+    }
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, JUMP_TABLE_MAGIC, sizeof(header.magic));
+    header.version = JUMP_TABLE_VERSION;
+    header.mexp = params->mexp;
+    header.kmin = kmin;
+    header.count = count;
+    header.words = words;
+    strcpy(header.idstr, params->idstr);
+    fwrite(&header, sizeof(header), 1, fp);
+    for (i = 0; i < count; i++) {
+	degree = poly_degree(coef + (size_t)words * i, words);
+	fwrite(&degree, sizeof(degree), 1, fp);
+    }
+    fwrite(coef, sizeof(uint64_t) * words, count, fp);
+    if (ferror(fp)) {
+	fclose(fp);
+	return -1;
+    }
+    return fclose(fp) == 0 ? 0 : -1;
+}
+
+/**
+ * This function writes a jump table file of a parameter set of the
+ * library, which holds the jump polynomials of 2^k 128-bit integers for
+ * k = kmin, ..., kmax.  The polynomials are calculated by squaring one
+ * by one, in time in the square of 128N for each k; sfmtjumpcalc
+ * writes the same files much faster.
+ * @param path the file name
+ * @param mexp Mersenne exponent, one of SFMT_MEXP_LIST
+ * @param kmin the first k, at least 0
+ * @param kmax the last k, at least kmin
+ * @return 0, or -1 if mexp is not supported, no memory or an I/O error
+ */
+int sfmt_write_jump_table(const char *path, int mexp, int kmin, int kmax) {
+    int d, k, r;
+    int words;
+    uint64_t *m, *x, *coef;
+    const sfmt_params_t *params = sfmt_get_params(mexp);
+
+    if (params == NULL || kmin < 0 || kmax < kmin) {
+	return -1;
+    }
+    words = params->n * 2 + 1;
+    m = malloc(sizeof(uint64_t) * (words * 3
+				   + (size_t)(words - 1) * (kmax - kmin + 1)));
+    if (m == NULL) {
+	return -1;
+    }
+    x = m + words;
+    coef = x + words * 2;
+    d = sfmt_min_poly(params, m);
+    if (d < 0) {
+	free(m);
+	return -1;
+    }
+    /* x^(2^k) = (x^(2^(k - 1)))^2 */
+    memset(x, 0, sizeof(uint64_t) * words * 2);
+    x[0] = 2;
+    for (k = 0; k <= kmax; k++) {
+	if (k >= kmin) {
+	    memcpy(coef + (size_t)(words - 1) * (k - kmin), x,
+		   sizeof(uint64_t) * (words - 1));
+	}
+	sqr_mod(x, m, d, words, 0);
+    }
+    r = sfmt_save_jump_table(path, params, kmin, kmax - kmin + 1, coef);
+    free(m);
+    return r;
+}
+
+/**
+ * This function maps a jump table file into memory.  The file must be
+ * of the parameter set of mexp, with the same identification string
+ * as get_idstring(); the polynomials are used where they are mapped,
+ * without being copied.
+ * @param path the file name
+ * @param mexp Mersenne exponent, one of SFMT_MEXP_LIST
+ * @return the jump table, or NULL if the file is not a jump table of
+ * mexp, the powers of 2 or a degree are out of range, no memory or an
+ * I/O error
+ */
+sfmt_jump_table *sfmt_open_jump_table(const char *path, int mexp) {
+    int i, fd;
+    struct stat st;
+    void *map;
+    const jump_table_header *header;
+    const uint64_t *degree;
+    const uint64_t *coef;
+    sfmt_jump_table *table;
+    const sfmt_params_t *params = sfmt_get_params(mexp);
+
+    if (params == NULL) {
+	return NULL;
+    }
+    fd = open(path, O_RDONLY);
+    if (fd < 0) {
+	return NULL;
+    }
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(*header)) {
+	close(fd);
+	return NULL;
+    }
+    map = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+	return NULL;
+    }
+    header = map;
+    if (memcmp(header->magic, JUMP_TABLE_MAGIC, sizeof(header->magic)) != 0
+	|| header->version != JUMP_TABLE_VERSION
+	|| header->mexp != (uint32_t)mexp
+	|| header->words != (uint32_t)params->n * 2
+	|| header->count == 0 || header->count > 4096
+	|| header->kmin > (uint32_t)INT_MAX - header->count
+	|| strncmp(header->idstr, params->idstr, sizeof(header->idstr)) != 0
+	|| (size_t)st.st_size != sizeof(*header) + sizeof(uint64_t)
+	* header->count * (1 + (size_t)header->words)) {
+	munmap(map, st.st_size);
+	return NULL;
+    }
+    degree = (const uint64_t *)(header + 1);
+    coef = degree + header->count;
+    /* apply_poly() reads the coefficients up to the degree */
+    for (i = 0; i < (int)header->count; i++) {
+	if (degree[i] >= (uint64_t)header->words * 64) {
+	    munmap(map, st.st_size);
+	    return NULL;
+	}
+    }
+    table = malloc(sizeof(sfmt_jump_table) + sizeof(jump_poly) * header->count);
+    if (table == NULL) {
+	munmap(map, st.st_size);
+	return NULL;
+    }
+    table->params = params;
+    table->kmin = header->kmin;
+    table->count = header->count;
+    table->map = map;
+    table->size = st.st_size;
+    table->polys = (jump_poly *)(table + 1);
+    for (i = 0; i < table->count; i++) {
+	table->polys[i].params = params;
+	table->polys[i].degree = (int)degree[i];
+	table->polys[i].coef = coef + (size_t)header->words * i;
+    }
+    return table;
+}
+
+/**
+ * This function unmaps a jump table file.
+ * @param table the jump table, or NULL
+ */
+void sfmt_close_jump_table(sfmt_jump_table *table) {
+    if (table != NULL) {
+	munmap(table->map, table->size);
+	free(table);
+    }
+}
+
+/**
+ * This function returns the jump polynomial of 2^k 128-bit integers in
+ * a jump table.
+ * @param table the jump table
+ * @param k the power of 2
+ * @return the jump polynomial, or NULL if k is not in the table
+ */
+const jump_poly *sfmt_jump_table_poly(const sfmt_jump_table *table, int k) {
+    if (k < table->kmin || k - table->kmin >= table->count) {
+	return NULL;
+    }
+    return &table->polys[k - table->kmin];
+}
+
+/**
+ * This function moves a state table ahead to the substream i of the
+ * substreams of 2^k 128-bit integers, that is, i * 2^k 128-bit integers
+ * ahead, by a jump of 2^(k + j) for each bit j of i.
+ * @param intstate internal state array of the parameter set of table
+ * @param table the jump table
+ * @param k the power of 2 of the length of the substreams
+ * @param i the index of the substream
+ * @return 0, or -1 if the table lacks a polynomial, when intstate is
+ * unchanged, or if no memory
+ */
+int sfmt_jump_substream(w128_t *intstate, const sfmt_jump_table *table,
+			int k, uint64_t i) {
+    int j;
+
+    for (j = 0; j < 64; j++) {
+	if (((i >> j) & 1) && sfmt_jump_table_poly(table, k + j) == NULL) {
+	    return -1;
+	}
+    }
+    for (j = 0; j < 64; j++) {
+	if (((i >> j) & 1)
+	    && sfmt_jump(intstate, sfmt_jump_table_poly(table, k + j)) != 0) {
+	    return -1;
+	}
+    }
+    return 0;
+}
+
+/**
+ * This function checks that count substreams of 2^stride 128-bit
+ * integers fit in the period of a parameter set, which is at least
+ * 2^mexp - 1 128-bit integers, and that i is one of them.
+ * @param params the parameter set
+ * @param stride the power of 2 of the length of the substreams
+ * @param count the number of the substreams, at least 1
+ * @param i the index of the substream
+ * @return 0, or -1 if not
+ */
+static int check_substream(const sfmt_params_t *params, int stride,
+			   uint64_t count, uint64_t i) {
+    int bits = 0;
+
+    if (stride < 0 || count == 0 || i >= count) {
+	return -1;
+    }
+    /* count <= 2^bits */
+    while (bits < 64 && ((uint64_t)1 << bits) < count) {
+	bits++;
+    }
+    return stride + bits < params->mexp ? 0 : -1;
+}
+
+/**
+ * This function initializes a state table with a 32-bit integer seed
+ * and moves it ahead to the substream i of count disjoint substreams of
+ * 2^stride 128-bit integers, i * 2^stride 128-bit integers from the
+ * start of the seed.  The substreams of a seed are the same for any
+ * count, so a worker of a job keeps its stream if the job has more or
+ * fewer workers.
+ * @param intstate internal state array of the parameter set of table
+ * @param table the jump table, with 2^(stride + j) for each bit j of i
+ * @param stride the power of 2 of the length of the substreams
+ * @param count the number of the substreams
+ * @param i the index of the substream, less than count
+ * @param seed a 32-bit integer used as the seed.
+ * @return 0, or -1 if i is not less than count, if count substreams do
+ * not fit in the period, if the table lacks a polynomial, or if no
+ * memory
+ */
+int sfmt_init_gen_rand_substream(w128_t *intstate,
+				 const sfmt_jump_table *table, int stride,
+				 uint64_t count, uint64_t i, uint32_t seed) {
+    if (check_substream(table->params, stride, count, i) != 0) {
+	return -1;
+    }
+    table->params->init_gen_rand(seed, intstate);
+    return sfmt_jump_substream(intstate, table, stride, i);
+}
+
+/**
+ * This function initializes a state table with an array of 32-bit
+ * integers used as the seeds and moves it ahead to the substream i of
+ * count disjoint substreams of 2^stride 128-bit integers, as
+ * sfmt_init_gen_rand_substream().
+ * @param intstate internal state array of the parameter set of table
+ * @param table the jump table
+ * @param stride the power of 2 of the length of the substreams
+ * @param count the number of the substreams
+ * @param i the index of the substream, less than count
+ * @param init_key the array of 32-bit integers, used as a seed.
+ * @param key_length the length of init_key.
+ * @return 0, or -1 if i is not less than count, if count substreams do
+ * not fit in the period, if the table lacks a polynomial, or if no
+ * memory
+ */
+int sfmt_init_by_array_substream(w128_t *intstate,
+				 const sfmt_jump_table *table, int stride,
+				 uint64_t count, uint64_t i,
+				 uint32_t *init_key, int key_length) {
+    if (check_substream(table->params, stride, count, i) != 0) {
+	return -1;
+    }
+    table->params->init_by_array(init_key, key_length, intstate);
+    return sfmt_jump_substream(intstate, table, stride, i);
+}
+
+/**
+ * This function splits a node of a tree of substreams into two.  A node
+ * is a state table and the substream of 2^level 128-bit integers which
+ * starts there; its children are the two halves, of 2^(level - 1)
+ * 128-bit integers.  The first child is parent itself, unchanged, and
+ * the second one is parent moved 2^(level - 1) 128-bit integers ahead
+ * by one jump, so the nodes of any path from a root are disjoint and
+ * depend on the path only, not on the order of the splits.  A split is
+ * not cheap: the jump takes as long as sfmt_jump(), 1 millisecond for
+ * MEXP 19937, far more than init_by_array(), so split a node once per
+ * task rather than per output.  Generate from a copy of a node, e.g. a
+ * generator object, to split it later.
+ * @param parent internal state array of the parameter set of table,
+ * the node
+ * @param child internal state array where the second child is stored
+ * @param table the jump table, with 2^(level - 1)
+ * @param level the power of 2 of the length of the substream of parent
+ * @return 0, or -1 if the table lacks a polynomial, when child is
+ * unchanged, or if no memory, when child is a copy of parent
+ */
+int sfmt_split(const w128_t *parent, w128_t *child,
+	       const sfmt_jump_table *table, int level) {
+    const jump_poly *p = sfmt_jump_table_poly(table, level - 1);
+
+    if (p == NULL) {
+	return -1;
+    }
+    memcpy(child, parent, sizeof(w128_t) * table->params->n);
+    return sfmt_jump(child, p);
+}
+
+/**
+ * This function moves the state table of a root of a tree of
+ * substreams to a node, the same as the splits of sfmt_split() along
+ * the path, with a jump for each second child on the path.
+ * @param intstate internal state array of the parameter set of table,
+ * the root
+ * @param table the jump table, with 2^(level - depth) to 2^(level - 1)
+ * @param level the power of 2 of the length of the substream of the
+ * root
+ * @param path the path, the bit depth - 1 for the first split, 0 for
+ * the first child and 1 for the second one
+ * @param depth the length of the path, 0 to 64
+ * @return 0, or -1 if depth is out of range or more than level, or if
+ * the table lacks a polynomial, when intstate is unchanged, or if no
+ * memory
+ */
+int sfmt_split_path(w128_t *intstate, const sfmt_jump_table *table,
+		    int level, uint64_t path, int depth) {
+    if (depth < 0 || depth > 64 || depth > level
+	|| (depth < 64 && (path >> depth) != 0)) {
+	return -1;
+    }
+    return sfmt_jump_substream(intstate, table, level - depth, path);
+}
+
+/**
+ * This function skips the next n 32-bit outputs of a generator, the
+ * same as n calls of sfmt_next32().  The state table is moved ahead to
+ * the block of the output n by the jumps of a jump table, for each bit
+ * of the number of the 128-bit integers of the skipped blocks, and the
+ * index is set in the block; a skip of less than 128N blocks, or any
+ * skip without a table, is done by gen_rand_all().  Seeding and then
+ * skipping n seeks the output n of a seed, e.g. 10^12 in 30
+ * milliseconds for MEXP 19937.
+ * @param sfmt the generator
+ * @param table the jump table of the parameter set of sfmt, with 2^k
+ * for k = 0 up to the bits of n / 4, or NULL
+ * @param n the number of the 32-bit outputs to skip
+ * @return 0, or -1 if the table is of another parameter set or lacks a
+ * polynomial, or if no memory; sfmt is unchanged then
+ */
+int sfmt_discard(sfmt_t *sfmt, const sfmt_jump_table *table, uint64_t n) {
+    int n32 = sfmt->n32;
+    size_t size = sizeof(w128_t) * sfmt->params->n;
+    uint64_t rest = (uint64_t)(n32 - sfmt->idx);
+    uint64_t q;
+    w128_t *copy;
+    void *p;
+
+    if (n < rest) {
+	sfmt->idx += (int)n;
+	return 0;
+    }
+    /* skip the rest of the table, q blocks, and n % n32 of the next */
+    n -= rest;
+    q = n / n32;
+    if (table != NULL && q >= (uint64_t)128 * sfmt->params->n) {
+	if (table->params != sfmt->params
+	    || posix_memalign(&p, 16, size) != 0) {
+	    return -1;
+	}
+	/* the jumps run on a copy, kept only if all of them succeed */
+	copy = p;
+	memcpy(copy, sfmt->state, size);
+	if (sfmt_jump_substream(copy, table, 0, q * sfmt->params->n) != 0) {
+	    free(copy);
+	    return -1;
+	}
+	memcpy(sfmt->state, copy, size);
+	free(copy);
+    } else {
+	for (; q > 0; q--) {
+	    sfmt->params->gen_rand_all(sfmt->state);
+	}
+    }
+    sfmt->params->gen_rand_all(sfmt->state);
+    sfmt->idx = (int)(n % n32);
+    return 0;
+}
@@ -0,0 +1,143 @@
+/* This file is a part of sfmt-extstate */
+
+/**
+ * @file  sfmt-extstate-lanes.c
+ * @brief leapfrog output of SFMT generator objects into lanes
+ *
+ * @author Kenji Rikitake
+ *
+ * Copyright (C) 2010 Kenji Rikitake. All rights reserved.
+ *
+ * The new BSD License is applied to this software, see LICENSE.txt
+ *
+ * @note The 32-bit outputs are dealt to L arrays, the lanes, in turn:
+ * the lane j gets the outputs j, j + L, j + 2L, ... of one stream, so
+ * that a SIMD kernel loads a row of its lanes contiguously instead of
+ * gathering with a stride of L.  The outputs are read directly from
+ * the state table of the generator in one pass; with SSE2, four rows
+ * of four lanes are transposed in registers at a time when L is a
+ * multiple of 4, and four rows of two lanes are shuffled when L is 2.
+ * A row which straddles a refill of the table is dealt one by one.
+ */
+#include "sfmt-extstate.h"
+
+/* static function prototypes */
+static void deal_rows(const uint32_t *src, uint32_t *lanes[], int count,
+		      int offset, int rows);
+
+#if defined(HAVE_SSE2)
+/**
+ * This function deals rows of 32-bit outputs to the lanes.
+ * @param src the outputs, rows * count of them
+ * @param lanes the lanes
+ * @param count the number of the lanes
+ * @param offset the row of the lanes to store the first row
+ * @param rows the number of the rows
+ */
+static void deal_rows(const uint32_t *src, uint32_t *lanes[], int count,
+		      int offset, int rows) {
+    int r = 0;
+    int g, j;
+    __m128i r0, r1, r2, r3, t0, t1, t2, t3;
+
+    if (count % 4 == 0) {
+	for (; r + 4 <= rows; r += 4) {
+	    for (g = 0; g < count; g += 4) {
+		r0 = _mm_loadu_si128((const __m128i *)&src[r * count + g]);
+		r1 = _mm_loadu_si128((const __m128i *)&src[(r + 1) * count + g]);
+		r2 = _mm_loadu_si128((const __m128i *)&src[(r + 2) * count + g]);
+		r3 = _mm_loadu_si128((const __m128i *)&src[(r + 3) * count + g]);
+		t0 = _mm_unpacklo_epi32(r0, r1);
+		t1 = _mm_unpacklo_epi32(r2, r3);
+		t2 = _mm_unpackhi_epi32(r0, r1);
+		t3 = _mm_unpackhi_epi32(r2, r3);
+		_mm_storeu_si128((__m128i *)&lanes[g][offset + r],
+				 _mm_unpacklo_epi64(t0, t1));
+		_mm_storeu_si128((__m128i *)&lanes[g + 1][offset + r],
+				 _mm_unpackhi_epi64(t0, t1));
+		_mm_storeu_si128((__m128i *)&lanes[g + 2][offset + r],
+				 _mm_unpacklo_epi64(t2, t3));
+		_mm_storeu_si128((__m128i *)&lanes[g + 3][offset + r],
+				 _mm_unpackhi_epi64(t2, t3));
+	    }
+	}
+    } else if (count == 2) {
+	for (; r + 4 <= rows; r += 4) {
+	    /* a0 b0 a1 b1, a2 b2 a3 b3 to a0 a1 b0 b1, a2 a3 b2 b3 */
+	    r0 = _mm_shuffle_epi32(
+		_mm_loadu_si128((const __m128i *)&src[r * 2]), 0xd8);
+	    r1 = _mm_shuffle_epi32(
+		_mm_loadu_si128((const __m128i *)&src[r * 2 + 4]), 0xd8);
+	    _mm_storeu_si128((__m128i *)&lanes[0][offset + r],
+			     _mm_unpacklo_epi64(r0, r1));
+	    _mm_storeu_si128((__m128i *)&lanes[1][offset + r],
+			     _mm_unpackhi_epi64(r0, r1));
+	}
+    }
+    for (; r < rows; r++) {
+	for (j = 0; j < count; j++) {
+	    lanes[j][offset + r] = src[r * count + j];
+	}
+    }
+}
+#else
+/**
+ * This function deals rows of 32-bit outputs to the lanes.
+ * @param src the outputs, rows * count of them
+ * @param lanes the lanes
+ * @param count the number of the lanes
+ * @param offset the row of the lanes to store the first row
+ * @param rows the number of the rows
+ */
+static void deal_rows(const uint32_t *src, uint32_t *lanes[], int count,
+		      int offset, int rows) {
+    int r, j;
+
+    for (r = 0; r < rows; r++) {
+	for (j = 0; j < count; j++) {
+	    lanes[j][offset + r] = src[r * count + j];
+	}
+    }
+}
+#endif /* HAVE_SSE2 */
+
+/**
+ * This function generates pseudorandom 32-bit integers into count
+ * arrays in turn by one call: the lane j gets the outputs j, j + count,
+ * j + 2 count, ... of sfmt_next32(), and count * size outputs are used
+ * in all.  The lanes may be of any alignment.
+ *
+ * @param sfmt the generator
+ * @param lanes count arrays where pseudorandom 32-bit integers are
+ * filled by this function.
+ * @param count the number of the lanes, at least 1
+ * @param size the number of 32-bit pseudorandom integers to be
+ * generated for each lane.
+ */
+void sfmt_fill_array32_lanes(sfmt_t *sfmt, uint32_t *lanes[], int count,
+			     int size) {
+    int r = 0;
+    int j, k;
+
+    while (r < size) {
+	if (sfmt->idx >= sfmt->n32) {
+	    sfmt->params->gen_rand_all(sfmt->state);
+	    sfmt->idx = 0;
+	}
+	k = (sfmt->n32 - sfmt->idx) / count;
+	if (k > size - r) {
+	    k = size - r;
+	}
+	if (k == 0) {
+	    /* a row which straddles a refill */
+	    for (j = 0; j < count; j++) {
+		lanes[j][r] = sfmt_next32(sfmt);
+	    }
+	    r++;
+	    continue;
+	}
+	deal_rows(&sfmt->state32[sfmt->idx], lanes, count, r, k);
+	sfmt->idx += k * count;
+	r += k;
+    }
+}
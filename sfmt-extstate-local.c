@@ -0,0 +1,181 @@
+/* This file is a part of sfmt-extstate */
+
+/**
+ * @file  sfmt-extstate-local.c
+ * @brief per-thread generators of disjoint substreams, node-local
+ *
+ * @author Kenji Rikitake
+ *
+ * Copyright (C) 2010 Kenji Rikitake. All rights reserved.
+ *
+ * The new BSD License is applied to this software, see LICENSE.txt
+ *
+ * @note A set of per-thread generators gives each thread which asks for
+ * one a generator of its own, on the first call in the thread, seeded
+ * with the substream i of count disjoint substreams of a seed, i taken
+ * by an atomic fetch-add in the order of the first calls.  The
+ * generator, the sfmt_t and its state table, is made in pages of its
+ * own mapped by mmap() and first written by the thread, so that Linux
+ * places them on the NUMA node of the thread without libnuma, and no
+ * two generators share a cache line.  The generator of a thread is
+ * kept in a pthread key, so finding it takes no lock.
+ */
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include "sfmt-extstate.h"
+
+/** the size of a cache line in bytes */
+#define CACHE_LINE 64
+
+/** the pages of the generator of a thread */
+struct LOCAL_GEN_T {
+    /** the generator */
+    sfmt_t sfmt;
+    /** the generator of the thread before, in the order of creation */
+    struct LOCAL_GEN_T *next;
+    /** size of the pages in bytes */
+    size_t size;
+};
+/** the pages of the generator of a thread */
+typedef struct LOCAL_GEN_T local_gen;
+
+/** a set of per-thread generators */
+struct SFMT_LOCAL_T {
+    /** the key of the generator of a thread */
+    pthread_key_t key;
+    /** the jump table of the substreams */
+    const sfmt_jump_table *table;
+    /** the power of 2 of the length of the substreams */
+    int stride;
+    /** the number of the substreams */
+    uint64_t count;
+    /** the seed of the substreams */
+    uint32_t seed;
+    /** the number of the substreams taken */
+    uint64_t taken;
+    /** the generator made last, the head of the list of all */
+    local_gen *gens;
+};
+
+/**
+ * This function makes a set of per-thread generators, of count disjoint
+ * substreams of 2^stride 128-bit integers of a seed, as
+ * sfmt_init_gen_rand_substream().  No generator is made until a thread
+ * asks for one.
+ * @param table the jump table, with 2^(stride + j) for each bit j of
+ * count - 1, kept until sfmt_free_local()
+ * @param stride the power of 2 of the length of the substreams
+ * @param count the number of the substreams, the most threads
+ * @param seed a 32-bit integer used as the seed.
+ * @return the set, or NULL if count is 0, count substreams do not fit
+ * in the period, or no memory or no key
+ */
+sfmt_local *sfmt_new_local(const sfmt_jump_table *table, int stride,
+			   uint64_t count, uint32_t seed) {
+    sfmt_local *local;
+    int bits = 0;
+
+    while (bits < 64 && ((uint64_t)1 << bits) < count) {
+	bits++;
+    }
+    if (count == 0 || stride < 0 || stride + bits >= table->params->mexp) {
+	return NULL;
+    }
+    local = malloc(sizeof(sfmt_local));
+    if (local == NULL) {
+	return NULL;
+    }
+    if (pthread_key_create(&local->key, NULL) != 0) {
+	free(local);
+	return NULL;
+    }
+    local->table = table;
+    local->stride = stride;
+    local->count = count;
+    local->seed = seed;
+    local->taken = 0;
+    local->gens = NULL;
+    return local;
+}
+
+/**
+ * This function frees a set of per-thread generators and all their
+ * generators, after all the threads are done with them.
+ * @param local the set, or NULL
+ */
+void sfmt_free_local(sfmt_local *local) {
+    local_gen *gen, *next;
+
+    if (local == NULL) {
+	return;
+    }
+    for (gen = local->gens; gen != NULL; gen = next) {
+	next = gen->next;
+	munmap(gen, gen->size);
+    }
+    pthread_key_delete(local->key);
+    free(local);
+}
+
+/**
+ * This function returns the generator of the calling thread, and makes
+ * it on the first call in the thread, with the next substream not
+ * taken.  The generator is for the thread only, until
+ * sfmt_free_local(); a thread which exits does not give its substream
+ * back.
+ * @param local the set
+ * @return the generator, or NULL if all the substreams are taken, the
+ * jump table lacks a polynomial, or no memory
+ */
+sfmt_t *sfmt_local_get(sfmt_local *local) {
+    local_gen *gen;
+    uint64_t i;
+    size_t header, size;
+    long page;
+    void *mem;
+    const sfmt_params_t *params = local->table->params;
+
+    gen = pthread_getspecific(local->key);
+    if (gen != NULL) {
+	return &gen->sfmt;
+    }
+    if (__atomic_load_n(&local->taken, __ATOMIC_RELAXED) >= local->count) {
+	return NULL;
+    }
+    i = __atomic_fetch_add(&local->taken, 1, __ATOMIC_RELAXED);
+    if (i >= local->count) {
+	return NULL;
+    }
+    /* fresh pages, placed on the node of the first thread to write them */
+    page = sysconf(_SC_PAGESIZE);
+    header = (sizeof(local_gen) + CACHE_LINE - 1) / CACHE_LINE * CACHE_LINE;
+    size = (header + sizeof(w128_t) * params->n + page - 1) / page * page;
+    mem = mmap(NULL, size, PROT_READ | PROT_WRITE,
+	       MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mem == MAP_FAILED) {
+	return NULL;
+    }
+    gen = mem;
+    gen->sfmt.state = (w128_t *)((char *)mem + header);
+    gen->sfmt.state32 = &gen->sfmt.state[0].u[0];
+    gen->sfmt.idx = params->n32;
+    gen->sfmt.n32 = params->n32;
+    gen->sfmt.params = params;
+    gen->size = size;
+    if (sfmt_init_gen_rand_substream(gen->sfmt.state, local->table,
+				     local->stride, local->count, i,
+				     local->seed) != 0
+	|| pthread_setspecific(local->key, gen) != 0) {
+	munmap(mem, size);
+	return NULL;
+    }
+    gen->next = __atomic_load_n(&local->gens, __ATOMIC_RELAXED);
+    while (!__atomic_compare_exchange_n(&local->gens, &gen->next, gen, 1,
+					__ATOMIC_RELEASE, __ATOMIC_RELAXED)) {
+    }
+    return &gen->sfmt;
+}
@@ -17,12 +17,14 @@
  */
 #include <string.h>
 #include <assert.h>
+#include "sfmt-params.h"
 #include "sfmt-extstate.h"
 
 /* public functions for the state tables */
 void period_certification(w128_t *intstate);
 const char *get_idstring(void);
 int get_min_array_size32(void);
+int get_min_array_size64(void);
 void init_gen_rand(uint32_t seed, w128_t *intstate);
 void init_by_array(uint32_t *init_key, int key_length, w128_t *intstate);
 
@@ -87,6 +89,15 @@ int get_min_array_size32(void) {
     return N32;
 }
 
+/**
+ * This function returns the minimum size of array used for \b
+ * fill_array64() function.
+ * @return minimum size of array used for fill_array64() function.
+ */
+int get_min_array_size64(void) {
+    return N * 2;
+}
+
 /**
  * This function represents a function used in the initialization
  * by init_by_array
@@ -209,3 +220,29 @@ void init_by_array(uint32_t *init_key, int key_length, w128_t *intstate) {
     period_certification(&intstate[0]);
 
 }
+
+#if defined(SFMT_MEXP_NAMES)
+/**
+ * the parameter set descriptor of this Mersenne exponent, with the
+ * table functions of sfmt-extstate-dispatch.c
+ */
+const sfmt_params_t SFMT_PASTE(sfmt_params_M, MEXP) = {
+    MEXP, N, N32, POS1, SL1, SL2, SR1, SR2,
+    {MSK1, MSK2, MSK3, MSK4},
+    {PARITY1, PARITY2, PARITY3, PARITY4},
+    IDSTR,
+    gen_rand_all,
+    gen_rand_all_reverse,
+    gen_rand_slice,
+    gen_rand_array,
+    gen_rand_all_double,
+    gen_rand_all_float,
+    gen_rand_all_x2,
+    gen_rand_array_x2,
+    gen_rand_all_x4,
+    gen_rand_array_x4,
+    period_certification,
+    init_gen_rand,
+    init_by_array
+};
+#endif /* SFMT_MEXP_NAMES */
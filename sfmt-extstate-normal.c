@@ -0,0 +1,340 @@
+/* This file is a part of sfmt-extstate */
+
+/**
+ * @file  sfmt-extstate-normal.c
+ * @brief normal deviates from SFMT generator objects by the ziggurat
+ * method
+ *
+ * @author Kenji Rikitake
+ *
+ * Copyright (C) 2010 Kenji Rikitake. All rights reserved.
+ *
+ * The new BSD License is applied to this software, see LICENSE.txt
+ *
+ * @note The ziggurat method (G. Marsaglia and W. W. Tsang, "The
+ * Ziggurat Method for Generating Random Variables", 2000) with 256
+ * layers of sfmt-normal-tables.h.  A double is made of a 64-bit output
+ * w: the layer i is the lowest 8 bits of w, the sign is the bit 8, and
+ * the upper 52 bits u give the candidate u * x[i] / 2^52, accepted if
+ * it is inside the rectangle of the layer, which is 98.8% of the
+ * cases.  Otherwise the wedge or the tail is sampled with more outputs
+ * of the generator, in double precision.  A float is made of a 32-bit
+ * output in the same way, with the upper 23 bits.
+ *
+ * The bulk functions take the accepted candidates directly from the
+ * state table of the generator, two doubles or four floats at a time
+ * with SSE2, and call the scalar functions from the first rejected one;
+ * the result is the same sequence as that of the scalar functions.  All
+ * the operations are exact or correctly rounded IEEE 754 operations,
+ * except exp() and log() of the rare slow path, so the sequence is the
+ * same on all the backends for a given seed.
+ */
+#include <math.h>
+#include "sfmt-extstate.h"
+#include "sfmt-normal-tables.h"
+
+/* static function prototypes */
+static int fast_normal(const uint32_t *words, int avail, double *array,
+		       int size);
+static int fast_normal_float(const uint32_t *words, int avail,
+			     float *array, int size);
+static double slow_normal(sfmt_t *sfmt, int i, double x);
+
+/**
+ * This function samples the wedge of a layer or the tail of the base
+ * layer, after a candidate is rejected by the rectangle.
+ * @param sfmt the generator
+ * @param i the layer
+ * @param x the rejected candidate, positive
+ * @return the accepted deviate, positive, or -1 if rejected
+ */
+static double slow_normal(sfmt_t *sfmt, int i, double x) {
+    double y;
+
+    if (i == 0) {
+	do {
+	    x = -log(1.0 - sfmt_next_double(sfmt)) / ZIG_R;
+	    y = -log(1.0 - sfmt_next_double(sfmt));
+	} while (y + y < x * x);
+	return ZIG_R + x;
+    }
+    if (zig_f[i] + sfmt_next_double(sfmt) * (zig_f[i + 1] - zig_f[i])
+	< exp(-0.5 * x * x)) {
+	return x;
+    }
+    return -1.0;
+}
+
+/**
+ * This function generates and returns a normal deviate of mean 0 and
+ * standard deviation 1.
+ * @param sfmt the generator
+ * @return normal deviate
+ */
+double sfmt_next_normal(sfmt_t *sfmt) {
+    uint64_t w;
+    int i;
+    double u, x;
+
+    for (;;) {
+	w = sfmt_next64(sfmt);
+	i = (int)(w & 0xff);
+	u = (double)(w >> 12);
+	x = u * zig_w[i];
+	if (u >= zig_k[i]) {
+	    x = slow_normal(sfmt, i, x);
+	    if (x < 0) {
+		continue;
+	    }
+	}
+	return (w & 0x100) ? -x : x;
+    }
+}
+
+/**
+ * This function generates and returns a normal deviate of mean 0 and
+ * standard deviation 1 in single precision.
+ * @param sfmt the generator
+ * @return normal deviate
+ */
+float sfmt_next_normal_float(sfmt_t *sfmt) {
+    uint32_t w;
+    int i;
+    float u, x;
+    double y;
+
+    for (;;) {
+	w = sfmt_next32(sfmt);
+	i = (int)(w & 0xff);
+	u = (float)(w >> 9);
+	x = u * zig_wf[i];
+	if (u >= zig_kf[i]) {
+	    y = slow_normal(sfmt, i, x);
+	    if (y < 0) {
+		continue;
+	    }
+	    x = (float)y;
+	}
+	return (w & 0x100) ? -x : x;
+    }
+}
+
+#if defined(HAVE_SSE2)
+/**
+ * This function converts 64-bit outputs into normal deviates while
+ * they are accepted by the rectangles of their layers.
+ * @param words 32-bit outputs, an even number of them from an even
+ * position of the sequence
+ * @param avail the number of 64-bit outputs in words
+ * @param array where the deviates are stored
+ * @param size the maximum number of the deviates
+ * @return the number of the deviates, which is that of the 64-bit
+ * outputs used
+ */
+static int fast_normal(const uint32_t *words, int avail, double *array,
+		       int size) {
+    int j;
+    int max = avail < size ? avail : size;
+    int i0, i1, mask;
+    __m128i w;
+    __m128d u, x;
+    const __m128i magic = _mm_set_epi32(0x43300000, 0, 0x43300000, 0);
+    const __m128d two52 = _mm_set1_pd(4503599627370496.0);
+    const __m128i sign = _mm_set_epi32(0x80000000, 0, 0x80000000, 0);
+
+    for (j = 0; j + 2 <= max; j += 2) {
+	w = _mm_loadu_si128((const __m128i *)&words[j * 2]);
+	i0 = words[j * 2] & 0xff;
+	i1 = words[j * 2 + 2] & 0xff;
+	/* the upper 52 bits as exact doubles */
+	u = _mm_sub_pd(_mm_castsi128_pd(_mm_or_si128(_mm_srli_epi64(w, 12),
+						     magic)), two52);
+	mask = _mm_movemask_pd(_mm_cmplt_pd(u, _mm_set_pd(zig_k[i1],
+							  zig_k[i0])));
+	x = _mm_mul_pd(u, _mm_set_pd(zig_w[i1], zig_w[i0]));
+	x = _mm_xor_pd(x, _mm_castsi128_pd(
+			   _mm_and_si128(_mm_slli_epi64(w, 55), sign)));
+	if (mask == 3) {
+	    _mm_storeu_pd(&array[j], x);
+	    continue;
+	}
+	if (mask == 1) {
+	    _mm_storel_pd(&array[j], x);
+	    return j + 1;
+	}
+	return j;
+    }
+    return j;
+}
+
+/**
+ * This function converts 32-bit outputs into normal deviates in single
+ * precision while they are accepted by the rectangles of their layers.
+ * @param words 32-bit outputs
+ * @param avail the number of 32-bit outputs in words
+ * @param array where the deviates are stored
+ * @param size the maximum number of the deviates
+ * @return the number of the deviates, which is that of the 32-bit
+ * outputs used
+ */
+static int fast_normal_float(const uint32_t *words, int avail,
+			     float *array, int size) {
+    int j;
+    int max = avail < size ? avail : size;
+    int mask;
+    __m128i w;
+    __m128 u, x;
+    const __m128i sign = _mm_set1_epi32(0x80000000);
+
+    for (j = 0; j + 4 <= max; j += 4) {
+	w = _mm_loadu_si128((const __m128i *)&words[j]);
+	u = _mm_cvtepi32_ps(_mm_srli_epi32(w, 9));
+	mask = _mm_movemask_ps(_mm_cmplt_ps(
+				   u, _mm_set_ps(zig_kf[words[j + 3] & 0xff],
+						 zig_kf[words[j + 2] & 0xff],
+						 zig_kf[words[j + 1] & 0xff],
+						 zig_kf[words[j] & 0xff])));
+	x = _mm_mul_ps(u, _mm_set_ps(zig_wf[words[j + 3] & 0xff],
+				     zig_wf[words[j + 2] & 0xff],
+				     zig_wf[words[j + 1] & 0xff],
+				     zig_wf[words[j] & 0xff]));
+	x = _mm_xor_ps(x, _mm_castsi128_ps(
+			   _mm_and_si128(_mm_slli_epi32(w, 23), sign)));
+	if (mask == 15) {
+	    _mm_storeu_ps(&array[j], x);
+	    continue;
+	}
+	/* the accepted ones before the first rejected one */
+	_mm_storeu_ps(&array[j], x);
+	for (mask = ~mask; (mask & 1) == 0; mask >>= 1) {
+	    j++;
+	}
+	return j;
+    }
+    return j;
+}
+#else
+/**
+ * This function converts 64-bit outputs into normal deviates while
+ * they are accepted by the rectangles of their layers.
+ * @param words 32-bit outputs, an even number of them from an even
+ * position of the sequence
+ * @param avail the number of 64-bit outputs in words
+ * @param array where the deviates are stored
+ * @param size the maximum number of the deviates
+ * @return the number of the deviates, which is that of the 64-bit
+ * outputs used
+ */
+static int fast_normal(const uint32_t *words, int avail, double *array,
+		       int size) {
+    int j;
+    int i;
+    uint64_t w;
+    double u, x;
+    int max = avail < size ? avail : size;
+
+    for (j = 0; j < max; j++) {
+	w = words[j * 2] | ((uint64_t)words[j * 2 + 1] << 32);
+	i = (int)(w & 0xff);
+	u = (double)(w >> 12);
+	if (u >= zig_k[i]) {
+	    break;
+	}
+	x = u * zig_w[i];
+	array[j] = (w & 0x100) ? -x : x;
+    }
+    return j;
+}
+
+/**
+ * This function converts 32-bit outputs into normal deviates in single
+ * precision while they are accepted by the rectangles of their layers.
+ * @param words 32-bit outputs
+ * @param avail the number of 32-bit outputs in words
+ * @param array where the deviates are stored
+ * @param size the maximum number of the deviates
+ * @return the number of the deviates, which is that of the 32-bit
+ * outputs used
+ */
+static int fast_normal_float(const uint32_t *words, int avail,
+			     float *array, int size) {
+    int j;
+    int i;
+    float u, x;
+    int max = avail < size ? avail : size;
+
+    for (j = 0; j < max; j++) {
+	i = (int)(words[j] & 0xff);
+	u = (float)(words[j] >> 9);
+	if (u >= zig_kf[i]) {
+	    break;
+	}
+	x = u * zig_wf[i];
+	array[j] = (words[j] & 0x100) ? -x : x;
+    }
+    return j;
+}
+#endif /* HAVE_SSE2 */
+
+/**
+ * This function generates normal deviates of mean 0 and standard
+ * deviation 1 in the specified array[] by one call, the same sequence
+ * as that of sfmt_next_normal().  At an odd position of the 32-bit
+ * sequence, all the deviates are generated by sfmt_next_normal().
+ *
+ * @param sfmt the generator
+ * @param array an array where the deviates are filled by this function.
+ * @param size the number of the deviates to be generated.
+ */
+void sfmt_fill_array_normal(sfmt_t *sfmt, double *array, int size) {
+    int k;
+
+    while (size > 0) {
+	if (sfmt->idx >= sfmt->n32) {
+	    sfmt->params->gen_rand_all(sfmt->state);
+	    sfmt->idx = 0;
+	}
+	if ((sfmt->idx & 1) == 0) {
+	    k = fast_normal(&sfmt->state32[sfmt->idx],
+			    (sfmt->n32 - sfmt->idx) / 2, array, size);
+	    sfmt->idx += k * 2;
+	    array += k;
+	    size -= k;
+	    if (size == 0 || sfmt->idx >= sfmt->n32) {
+		continue;
+	    }
+	}
+	*array++ = sfmt_next_normal(sfmt);
+	size--;
+    }
+}
+
+/**
+ * This function generates normal deviates of mean 0 and standard
+ * deviation 1 in single precision in the specified array[] by one
+ * call, the same sequence as that of sfmt_next_normal_float().
+ *
+ * @param sfmt the generator
+ * @param array an array where the deviates are filled by this function.
+ * @param size the number of the deviates to be generated.
+ */
+void sfmt_fill_array_normal_float(sfmt_t *sfmt, float *array, int size) {
+    int k;
+
+    while (size > 0) {
+	if (sfmt->idx >= sfmt->n32) {
+	    sfmt->params->gen_rand_all(sfmt->state);
+	    sfmt->idx = 0;
+	}
+	k = fast_normal_float(&sfmt->state32[sfmt->idx],
+			      sfmt->n32 - sfmt->idx, array, size);
+	sfmt->idx += k;
+	array += k;
+	size -= k;
+	if (size == 0 || sfmt->idx >= sfmt->n32) {
+	    continue;
+	}
+	*array++ = sfmt_next_normal_float(sfmt);
+	size--;
+    }
+}
@@ -0,0 +1,319 @@
+/* This file is a part of sfmt-extstate */
+
+/**
+ * @file  sfmt-extstate-pool.c
+ * @brief parallel fill of large arrays by a thread pool
+ *
+ * @author Kenji Rikitake
+ *
+ * Copyright (C) 2010 Kenji Rikitake. All rights reserved.
+ *
+ * The new BSD License is applied to this software, see LICENSE.txt
+ *
+ * @note An array of gen_rand_array() is cut into chunks of a fixed
+ * number of 128-bit integers, the last one taking the remainder.  The
+ * state table which starts a chunk is that of the previous chunk moved
+ * ahead by sfmt_jump() with the jump polynomial of the chunk size,
+ * computed once by sfmt_new_pool().  The threads take the chunks in
+ * order; a thread first makes the state table of the next chunk from
+ * that of its own, so that the jumps form a chain of one jump per
+ * chunk, and then fills its chunk by gen_rand_array() while the other
+ * threads go on.  The chunks therefore have to take longer to fill
+ * than a jump times the number of the threads, see sfmt_new_pool().
+ *
+ * The output is the same as that of gen_rand_array() alone, and so is
+ * the state table left, the last N 128-bit integers of the array.
+ */
+#define _POSIX_C_SOURCE 200112L
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <pthread.h>
+#include "sfmt-extstate.h"
+
+/** a thread pool filling arrays of a parameter set */
+struct SFMT_POOL_T {
+    /** the parameter set */
+    const sfmt_params_t *params;
+    /** size of a chunk in 128-bit integers */
+    int chunk;
+    /** the jump polynomial of chunk 128-bit integers */
+    jump_poly *jump;
+    /** the number of the threads, including the caller */
+    int threads;
+    /** the threads other than the caller */
+    pthread_t *workers;
+    /** the lock of the members below */
+    pthread_mutex_t lock;
+    /** signaled when any of the members below changes */
+    pthread_cond_t cond;
+    /** the serial number of the current fill */
+    unsigned long job;
+    /** set when the workers should exit */
+    int quit;
+    /** the array of the current fill */
+    w128_t *array;
+    /** size of array in 128-bit integers */
+    int size;
+    /** the number of the chunks of array */
+    int chunks;
+    /** the state tables which start the chunks */
+    w128_t *starts;
+    /** the next chunk to take */
+    int next;
+    /** the number of the chunks of which the start is ready */
+    int ready;
+    /** the number of the chunks done */
+    int done;
+    /** set if a jump has failed */
+    int error;
+};
+
+/* static function prototypes */
+static void run_chunks(sfmt_pool *pool);
+static void *worker(void *arg);
+
+/**
+ * This function takes and fills the chunks of the current fill until
+ * none is left.  The lock is held on entry and on exit.
+ * @param pool the pool
+ */
+static void run_chunks(sfmt_pool *pool) {
+    int c, n, size;
+    int error;
+    w128_t *start;
+
+    n = pool->params->n;
+    while (pool->next < pool->chunks) {
+	c = pool->next++;
+	while (pool->ready <= c && !pool->error) {
+	    pthread_cond_wait(&pool->cond, &pool->lock);
+	}
+	if (pool->error) {
+	    pool->done++;
+	    continue;
+	}
+	pthread_mutex_unlock(&pool->lock);
+	start = pool->starts + (size_t)c * n;
+	error = 0;
+	if (c + 1 < pool->chunks) {
+	    memcpy(start + n, start, sizeof(w128_t) * n);
+	    error = sfmt_jump(start + n, pool->jump);
+	    pthread_mutex_lock(&pool->lock);
+	    if (error) {
+		pool->error = 1;
+	    } else {
+		pool->ready = c + 2;
+	    }
+	    pthread_cond_broadcast(&pool->cond);
+	    pthread_mutex_unlock(&pool->lock);
+	}
+	if (!error) {
+	    size = c + 1 < pool->chunks ? pool->chunk
+		: pool->size - c * pool->chunk;
+	    pool->params->gen_rand_array(pool->array + (size_t)c * pool->chunk,
+					 size, start);
+	}
+	pthread_mutex_lock(&pool->lock);
+	pool->done++;
+	if (pool->done == pool->chunks) {
+	    pthread_cond_broadcast(&pool->cond);
+	}
+    }
+}
+
+/**
+ * This function is the body of the threads of a pool, which wait for
+ * a fill and take part in it.
+ * @param arg the pool
+ * @return NULL
+ */
+static void *worker(void *arg) {
+    sfmt_pool *pool = arg;
+    unsigned long seen = 0;
+
+    pthread_mutex_lock(&pool->lock);
+    for (;;) {
+	while (!pool->quit && pool->job == seen) {
+	    pthread_cond_wait(&pool->cond, &pool->lock);
+	}
+	if (pool->quit) {
+	    break;
+	}
+	seen = pool->job;
+	run_chunks(pool);
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return NULL;
+}
+
+/**
+ * This function allocates a thread pool which fills arrays of a
+ * Mersenne exponent in chunks of chunk 128-bit integers.  This computes
+ * the jump polynomial of chunk by sfmt_new_jump_poly(), e.g. 0.4
+ * seconds for MEXP 19937 and 40 seconds for MEXP 216091, so keep a
+ * pool for many fills.  A chunk should take longer to fill than
+ * sfmt_jump() times threads, e.g. chunk = 2^22 (64 MB) for MEXP 19937
+ * and 8 threads.
+ * @param mexp Mersenne exponent, one of SFMT_MEXP_LIST
+ * @param threads the number of the threads, including the caller of
+ * the fills
+ * @param chunk size of a chunk in 128-bit integers, at least N
+ * @return the pool, or NULL if mexp is not supported, chunk is less
+ * than N, threads is less than 1, no memory or no thread
+ */
+sfmt_pool *sfmt_new_pool(int mexp, int threads, int chunk) {
+    int i;
+    uint32_t step = (uint32_t)chunk;
+    sfmt_pool *pool;
+    const sfmt_params_t *params = sfmt_get_params(mexp);
+
+    if (params == NULL || chunk < params->n || threads < 1) {
+	return NULL;
+    }
+    pool = calloc(1, sizeof(sfmt_pool));
+    if (pool == NULL) {
+	return NULL;
+    }
+    pool->params = params;
+    pool->chunk = chunk;
+    pool->threads = threads;
+    pool->jump = sfmt_new_jump_poly(mexp, &step, 1);
+    pool->workers = malloc(sizeof(pthread_t) * threads);
+    if (pool->jump == NULL || pool->workers == NULL) {
+	sfmt_free_jump_poly(pool->jump);
+	free(pool->workers);
+	free(pool);
+	return NULL;
+    }
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->cond, NULL);
+    for (i = 0; i < threads - 1; i++) {
+	if (pthread_create(&pool->workers[i], NULL, worker, pool) != 0) {
+	    pool->threads = i + 1;
+	    sfmt_free_pool(pool);
+	    return NULL;
+	}
+    }
+    return pool;
+}
+
+/**
+ * This function stops the threads of a pool and frees it.
+ * @param pool the pool, or NULL
+ */
+void sfmt_free_pool(sfmt_pool *pool) {
+    int i;
+
+    if (pool == NULL) {
+	return;
+    }
+    pthread_mutex_lock(&pool->lock);
+    pool->quit = 1;
+    pthread_cond_broadcast(&pool->cond);
+    pthread_mutex_unlock(&pool->lock);
+    for (i = 0; i < pool->threads - 1; i++) {
+	pthread_join(pool->workers[i], NULL);
+    }
+    pthread_cond_destroy(&pool->cond);
+    pthread_mutex_destroy(&pool->lock);
+    sfmt_free_jump_poly(pool->jump);
+    free(pool->workers);
+    free(pool);
+}
+
+/**
+ * This function generates pseudorandom 32-bit integers in the
+ * specified array[] by the threads of a pool, the same as
+ * gen_rand_array() of the parameter set of the pool: the array holds
+ * the next size 128-bit integers of intstate, and intstate is left as
+ * its last N 128-bit integers.  An array of less than two chunks is
+ * filled by the caller alone, and so is any array if no memory.  Only
+ * one fill at a time is allowed for a pool.
+ *
+ * @param pool the pool
+ * @param array an 128-bit array to be filled by pseudorandom numbers.
+ * @param size number of 128-bit pseudorandom numbers to be generated,
+ * at least N.
+ * @param intstate internal state array of the parameter set of pool
+ */
+void sfmt_pool_gen_rand_array(sfmt_pool *pool, w128_t *array, int size,
+			      w128_t *intstate) {
+    int n = pool->params->n;
+    int chunks = size / pool->chunk;
+    int error;
+    void *starts;
+
+    if (chunks < 2
+	|| posix_memalign(&starts, 64, sizeof(w128_t) * n * (size_t)chunks)
+	!= 0) {
+	pool->params->gen_rand_array(array, size, intstate);
+	return;
+    }
+    memcpy(starts, intstate, sizeof(w128_t) * n);
+    pthread_mutex_lock(&pool->lock);
+    pool->array = array;
+    pool->size = size;
+    pool->chunks = chunks;
+    pool->starts = starts;
+    pool->next = 0;
+    pool->ready = 1;
+    pool->done = 0;
+    pool->error = 0;
+    pool->job++;
+    pthread_cond_broadcast(&pool->cond);
+    run_chunks(pool);
+    while (pool->done < pool->chunks) {
+	pthread_cond_wait(&pool->cond, &pool->lock);
+    }
+    error = pool->error;
+    pool->chunks = 0;
+    pthread_mutex_unlock(&pool->lock);
+    free(starts);
+    if (error) {
+	pool->params->gen_rand_array(array, size, intstate);
+	return;
+    }
+    memcpy(intstate, array + size - n, sizeof(w128_t) * n);
+}
+
+/**
+ * This function generates pseudorandom 32-bit integers in the
+ * specified array[] by the threads of a pool, the same as
+ * sfmt_fill_array32() and with the same effect on the generator.  The
+ * generator is of the parameter set of the pool; otherwise the caller
+ * fills the array alone.
+ *
+ * @param pool the pool
+ * @param sfmt the generator
+ * @param array an array where pseudorandom 32-bit integers are filled
+ * by this function.
+ * @param size the number of 32-bit pseudorandom integers to be
+ * generated.
+ */
+void sfmt_pool_fill_array32(sfmt_pool *pool, sfmt_t *sfmt, uint32_t *array,
+			    int size) {
+    int count;
+
+    if (sfmt->params != pool->params) {
+	sfmt_fill_array32(sfmt, array, size);
+	return;
+    }
+    /* the rest of the table; all of array if the part after it is not
+       aligned, as sfmt_fill_array32() never calls gen_rand_array() then */
+    count = sfmt->n32 - sfmt->idx;
+    if (count > size || ((uintptr_t)(array + count) & 15) != 0) {
+	count = size;
+    }
+    sfmt_fill_array32(sfmt, array, count);
+    array += count;
+    size -= count;
+    if (size >= sfmt->n32) {
+	count = size & ~3;
+	sfmt_pool_gen_rand_array(pool, (w128_t *)array, count / 4,
+				 sfmt->state);
+	array += count;
+	size -= count;
+    }
+    sfmt_fill_array32(sfmt, array, size);
+}
@@ -0,0 +1,288 @@
+/* This file is a part of sfmt-extstate */
+
+/**
+ * @file  sfmt-extstate-ring.c
+ * @brief a producer thread generating blocks ahead into a ring
+ *
+ * @author Kenji Rikitake
+ *
+ * Copyright (C) 2010 Kenji Rikitake. All rights reserved.
+ *
+ * The new BSD License is applied to this software, see LICENSE.txt
+ *
+ * @note The producer thread owns a copy of the state table of a
+ * generator, and makes the blocks of its stream ahead of the reader by
+ * gen_rand_array() into a ring of count blocks of tables state tables
+ * each.  The producer and the reader each write a counter on a cache
+ * line of its own, head and tail, and take no lock while the ring is
+ * neither full nor empty; the inline functions of the reader only
+ * advance an index, and take the next block of the ring once a block.
+ * A side which finds the ring full or empty sleeps on a condition
+ * variable until the other side wakes it, the producer only when the
+ * ring is half empty again, so that a slower reader does not wake it
+ * every block.  The reader first reads the rest of the table of the
+ * generator, so the output is the same as that of the generator.
+ */
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <pthread.h>
+#include <sched.h>
+#include "sfmt-extstate.h"
+
+/** the size of a cache line in bytes */
+#define CACHE_LINE 64
+
+/** a ring of blocks and its producer thread */
+struct SFMT_PRODUCER_T {
+    /** the number of the blocks made, written by the producer */
+    unsigned long head;
+    /** set while the producer sleeps */
+    int producer_waiting;
+    /** the rest of the cache line of the producer */
+    char pad0[CACHE_LINE - sizeof(unsigned long) - sizeof(int)];
+    /** the number of the blocks released, written by the reader */
+    unsigned long tail;
+    /** the number of the blocks taken by the reader */
+    unsigned long taken;
+    /** set while the reader sleeps */
+    int reader_waiting;
+    /** the rest of the cache line of the reader */
+    char pad1[CACHE_LINE - 2 * sizeof(unsigned long) - sizeof(int)];
+    /** the parameter set */
+    const sfmt_params_t *params;
+    /** the number of the blocks of the ring */
+    int count;
+    /** size of a block in 128-bit integers */
+    int size;
+    /** the ring, count blocks */
+    w128_t *blocks;
+    /** the state table of the producer, after the last block made */
+    w128_t *intstate;
+    /** the table of the generator, read before the ring */
+    w128_t *first;
+    /** the producer thread */
+    pthread_t thread;
+    /** the lock of the sleeps */
+    pthread_mutex_t lock;
+    /** signaled when a sleeping side should wake up */
+    pthread_cond_t cond;
+    /** set when the producer should exit */
+    int quit;
+};
+
+/* static function prototypes */
+static void wake(struct SFMT_PRODUCER_T *p);
+static int wait_free(struct SFMT_PRODUCER_T *p, unsigned long head);
+static void *produce(void *arg);
+
+/**
+ * This function wakes the side sleeping on a ring.
+ * @param p the ring
+ */
+static void wake(struct SFMT_PRODUCER_T *p) {
+    pthread_mutex_lock(&p->lock);
+    pthread_cond_broadcast(&p->cond);
+    pthread_mutex_unlock(&p->lock);
+}
+
+/**
+ * This function waits for a free block of a ring for the producer.
+ * If the ring is full, the producer sleeps until it is half empty.
+ * @param p the ring
+ * @param head the number of the blocks made
+ * @return 1, or 0 if the producer should exit
+ */
+static int wait_free(struct SFMT_PRODUCER_T *p, unsigned long head) {
+    int quit;
+
+    if (__atomic_load_n(&p->quit, __ATOMIC_RELAXED)) {
+	return 0;
+    }
+    if (head - __atomic_load_n(&p->tail, __ATOMIC_ACQUIRE)
+	< (unsigned long)p->count) {
+	return 1;
+    }
+    pthread_mutex_lock(&p->lock);
+    __atomic_store_n(&p->producer_waiting, 1, __ATOMIC_SEQ_CST);
+    while (!p->quit && head - __atomic_load_n(&p->tail, __ATOMIC_SEQ_CST)
+	   > (unsigned long)p->count / 2) {
+	pthread_cond_wait(&p->cond, &p->lock);
+    }
+    __atomic_store_n(&p->producer_waiting, 0, __ATOMIC_RELAXED);
+    quit = p->quit;
+    pthread_mutex_unlock(&p->lock);
+    return !quit;
+}
+
+/**
+ * This function is the body of the producer thread, which makes the
+ * blocks of a ring in turn until it should exit.
+ * @param arg the ring
+ * @return NULL
+ */
+static void *produce(void *arg) {
+    struct SFMT_PRODUCER_T *p = arg;
+    unsigned long head;
+
+    for (head = 0; wait_free(p, head); head++) {
+	p->params->gen_rand_array(p->blocks
+				  + (size_t)(head % p->count) * p->size,
+				  p->size, p->intstate);
+	__atomic_store_n(&p->head, head + 1, __ATOMIC_SEQ_CST);
+	if (__atomic_load_n(&p->reader_waiting, __ATOMIC_SEQ_CST)) {
+	    wake(p);
+	}
+    }
+    return NULL;
+}
+
+/**
+ * This function starts a producer thread which generates the stream of
+ * a generator ahead into a ring of count blocks of tables state tables,
+ * and returns the reader of the ring.  The stream read from the ring
+ * starts at the next output of the generator, and the generator should
+ * not be used until sfmt_free_ring() gives it back.
+ * @param sfmt the generator
+ * @param count the number of the blocks of the ring, at least 2
+ * @param tables size of a block in state tables, at least 1
+ * @param cpu the CPU the producer thread is pinned to, or -1; ignored
+ * but on Linux
+ * @return the reader, or NULL if count or tables is out of range, no
+ * memory or no thread
+ */
+sfmt_ring *sfmt_new_ring(sfmt_t *sfmt, int count, int tables, int cpu) {
+    int n = sfmt->params->n;
+    int error;
+    void *mem;
+    sfmt_ring *ring;
+    struct SFMT_PRODUCER_T *p;
+    pthread_attr_t attr;
+#if defined(__linux__)
+    cpu_set_t set;
+#endif
+
+    if (count < 2 || tables < 1 || tables > INT_MAX / 4 / n) {
+	return NULL;
+    }
+    if (posix_memalign(&mem, CACHE_LINE, sizeof(sfmt_ring)) != 0) {
+	return NULL;
+    }
+    ring = mem;
+    if (posix_memalign(&mem, CACHE_LINE, sizeof(struct SFMT_PRODUCER_T))
+	!= 0) {
+	free(ring);
+	return NULL;
+    }
+    p = mem;
+    if (posix_memalign(&mem, CACHE_LINE, sizeof(w128_t)
+		       * ((size_t)count * tables * n + 2 * n)) != 0) {
+	free(p);
+	free(ring);
+	return NULL;
+    }
+    memset(p, 0, sizeof(struct SFMT_PRODUCER_T));
+    p->params = sfmt->params;
+    p->count = count;
+    p->size = tables * n;
+    p->blocks = mem;
+    p->intstate = p->blocks + (size_t)count * p->size;
+    p->first = p->intstate + n;
+    memcpy(p->intstate, sfmt->state, sizeof(w128_t) * n);
+    memcpy(p->first, sfmt->state, sizeof(w128_t) * n);
+    pthread_mutex_init(&p->lock, NULL);
+    pthread_cond_init(&p->cond, NULL);
+    ring->block32 = &p->first[0].u[0];
+    ring->idx = sfmt->idx;
+    ring->size32 = sfmt->n32;
+    ring->producer = p;
+    pthread_attr_init(&attr);
+#if defined(__linux__)
+    if (cpu >= 0) {
+	CPU_ZERO(&set);
+	CPU_SET(cpu, &set);
+	pthread_attr_setaffinity_np(&attr, sizeof(set), &set);
+    }
+#endif
+    error = pthread_create(&p->thread, &attr, produce, p);
+    pthread_attr_destroy(&attr);
+    if (error != 0) {
+	pthread_cond_destroy(&p->cond);
+	pthread_mutex_destroy(&p->lock);
+	free(p->blocks);
+	free(p);
+	free(ring);
+	return NULL;
+    }
+    return ring;
+}
+
+/**
+ * This function stops the producer thread of a ring and frees it.  The
+ * generator the ring was made from, if given, is set to go on from the
+ * next output of the ring.
+ * @param ring the reader of the ring, or NULL
+ * @param sfmt the generator the ring was made from, or NULL
+ */
+void sfmt_free_ring(sfmt_ring *ring, sfmt_t *sfmt) {
+    struct SFMT_PRODUCER_T *p;
+    int n32, j;
+
+    if (ring == NULL) {
+	return;
+    }
+    p = ring->producer;
+    pthread_mutex_lock(&p->lock);
+    __atomic_store_n(&p->quit, 1, __ATOMIC_RELAXED);
+    pthread_cond_broadcast(&p->cond);
+    pthread_mutex_unlock(&p->lock);
+    pthread_join(p->thread, NULL);
+    if (sfmt != NULL && sfmt->params == p->params) {
+	/* the table of the block being read of the next output */
+	n32 = p->params->n32;
+	j = ring->idx < ring->size32 ? ring->idx / n32
+	    : ring->size32 / n32 - 1;
+	memcpy(sfmt->state, ring->block32 + (size_t)j * n32,
+	       sizeof(w128_t) * p->params->n);
+	sfmt->idx = ring->idx - j * n32;
+    }
+    pthread_cond_destroy(&p->cond);
+    pthread_mutex_destroy(&p->lock);
+    free(p->blocks);
+    free(p);
+    free(ring);
+}
+
+/**
+ * This function releases the block of a ring read by the reader and
+ * takes the next one, sleeping until the producer has made it.  This
+ * is called by sfmt_ring_next32() at the end of a block.
+ * @param ring the reader of the ring
+ */
+void sfmt_ring_next_block(sfmt_ring *ring) {
+    struct SFMT_PRODUCER_T *p = ring->producer;
+    unsigned long taken = p->taken;
+
+    if (taken > 0) {
+	__atomic_store_n(&p->tail, taken, __ATOMIC_SEQ_CST);
+	if (__atomic_load_n(&p->producer_waiting, __ATOMIC_SEQ_CST)
+	    && __atomic_load_n(&p->head, __ATOMIC_ACQUIRE) - taken
+	    <= (unsigned long)p->count / 2) {
+	    wake(p);
+	}
+    }
+    if (__atomic_load_n(&p->head, __ATOMIC_ACQUIRE) == taken) {
+	pthread_mutex_lock(&p->lock);
+	__atomic_store_n(&p->reader_waiting, 1, __ATOMIC_SEQ_CST);
+	while (__atomic_load_n(&p->head, __ATOMIC_SEQ_CST) == taken) {
+	    pthread_cond_wait(&p->cond, &p->lock);
+	}
+	__atomic_store_n(&p->reader_waiting, 0, __ATOMIC_RELAXED);
+	pthread_mutex_unlock(&p->lock);
+    }
+    ring->block32 = &p->blocks[(size_t)(taken % p->count) * p->size].u[0];
+    ring->idx = 0;
+    ring->size32 = p->size * 4;
+    p->taken = taken + 1;
+}
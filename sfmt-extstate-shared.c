@@ -0,0 +1,284 @@
+/* This file is a part of sfmt-extstate */
+
+/**
+ * @file  sfmt-extstate-shared.c
+ * @brief a generator shared by threads which claim ranges of its output
+ *
+ * @author Kenji Rikitake
+ *
+ * Copyright (C) 2010 Kenji Rikitake. All rights reserved.
+ *
+ * The new BSD License is applied to this software, see LICENSE.txt
+ *
+ * @note The stream of a shared generator is the rest of the table of
+ * the generator it was made from, followed by the blocks 0, 1, 2, ...
+ * of tables state tables each, made by gen_rand_array() into a ring of
+ * count slots.  A thread claims a range of the stream by an atomic
+ * fetch-add on the cursor, and copies it out of the slots; the thread
+ * whose range has the first output of a block makes the block, from the
+ * last state table of the block before, once the readers of the block
+ * count blocks before have released its slot.  Each slot publishes the
+ * block it holds by a compare-and-swap of its epoch, the block number
+ * plus 1, on a cache line of its own; the readers of a slot add the
+ * outputs they copied to its count on another one.  No state table is
+ * written by more than one thread, and no lock is taken: a thread
+ * waiting for a block or a slot yields its CPU.
+ */
+#define _POSIX_C_SOURCE 200112L
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <sched.h>
+#include "sfmt-extstate.h"
+
+/** the size of a cache line in bytes */
+#define CACHE_LINE 64
+
+/** a slot of the ring of a shared generator */
+struct SHARED_SLOT_T {
+    /** the block held plus 1, or 0 if none yet */
+    uint64_t epoch;
+    /** the rest of the cache line of the epoch */
+    char pad0[CACHE_LINE - sizeof(uint64_t)];
+    /** the number of the outputs of the block copied by the readers */
+    int consumed;
+    /** the rest of the cache line of the readers */
+    char pad1[CACHE_LINE - sizeof(int)];
+    /** the block, size 128-bit integers */
+    w128_t *block;
+    /** the state table of the maker of the block */
+    w128_t *state;
+    /** the rest of the cache line of the block */
+    char pad2[CACHE_LINE - 2 * sizeof(w128_t *)];
+};
+/** a slot of the ring of a shared generator */
+typedef struct SHARED_SLOT_T shared_slot;
+
+/** a generator shared by threads */
+struct SFMT_SHARED_T {
+    /** the next unclaimed output of the stream */
+    uint64_t cursor;
+    /** the rest of the cache line of the cursor */
+    char pad0[CACHE_LINE - sizeof(uint64_t)];
+    /** the position of the first output, the index of the generator */
+    int origin;
+    /** the parameter set */
+    const sfmt_params_t *params;
+    /** the number of the slots */
+    int count;
+    /** size of a block in 128-bit integers */
+    int size;
+    /** size of a block in 32-bit integers */
+    int size32;
+    /** the table of the generator, the outputs 0 to n32 - 1 */
+    w128_t *first;
+    /** the ring, count slots */
+    shared_slot *slots;
+};
+
+/* static function prototypes */
+static void wait_epoch(const shared_slot *slot, uint64_t epoch);
+static void make_block(sfmt_shared *shared, uint64_t b);
+
+/**
+ * This function waits until a slot holds a block.
+ * @param slot the slot
+ * @param epoch the block plus 1
+ */
+static void wait_epoch(const shared_slot *slot, uint64_t epoch) {
+    while (__atomic_load_n(&slot->epoch, __ATOMIC_ACQUIRE) != epoch) {
+	sched_yield();
+    }
+}
+
+/**
+ * This function makes a block of a shared generator into its slot, and
+ * publishes it.  This is called by the thread which claimed the first
+ * output of the block.
+ * @param shared the shared generator
+ * @param b the block
+ */
+static void make_block(sfmt_shared *shared, uint64_t b) {
+    int n = shared->params->n;
+    shared_slot *slot = &shared->slots[b % shared->count];
+    const w128_t *last;
+    uint64_t epoch;
+
+    if (b == 0) {
+	last = shared->first;
+    } else {
+	/* the block before is not overwritten before this one is made */
+	wait_epoch(&shared->slots[(b - 1) % shared->count], b);
+	last = shared->slots[(b - 1) % shared->count].block
+	    + shared->size - n;
+    }
+    /* the slot holds the block count blocks before, all made by now */
+    epoch = b >= (uint64_t)shared->count ? b - shared->count + 1 : 0;
+    if (epoch > 0) {
+	while (__atomic_load_n(&slot->consumed, __ATOMIC_ACQUIRE)
+	       < shared->size32) {
+	    sched_yield();
+	}
+    }
+    memcpy(slot->state, last, sizeof(w128_t) * n);
+    shared->params->gen_rand_array(slot->block, shared->size, slot->state);
+    __atomic_store_n(&slot->consumed, 0, __ATOMIC_RELAXED);
+    if (!__atomic_compare_exchange_n(&slot->epoch, &epoch, b + 1, 0,
+				     __ATOMIC_RELEASE, __ATOMIC_RELAXED)) {
+	/* another thread claimed the same block */
+	abort();
+    }
+}
+
+/**
+ * This function makes a generator shared by threads, whose stream
+ * starts at the next output of a generator.  The generator should not
+ * be used until sfmt_free_shared() gives it back.
+ * @param sfmt the generator
+ * @param count the number of the blocks of the ring, at least 2
+ * @param tables size of a block in state tables, at least 1
+ * @return the shared generator, or NULL if count or tables is out of
+ * range, or no memory
+ */
+sfmt_shared *sfmt_new_shared(sfmt_t *sfmt, int count, int tables) {
+    int n = sfmt->params->n;
+    int i;
+    void *mem;
+    w128_t *tables_mem;
+    sfmt_shared *shared;
+
+    if (count < 2 || count > INT_MAX / 2 || tables < 1
+	|| tables > INT_MAX / 4 / n) {
+	return NULL;
+    }
+    if (posix_memalign(&mem, CACHE_LINE, sizeof(sfmt_shared)) != 0) {
+	return NULL;
+    }
+    shared = mem;
+    if (posix_memalign(&mem, CACHE_LINE, sizeof(shared_slot) * count) != 0) {
+	free(shared);
+	return NULL;
+    }
+    shared->slots = mem;
+    if (posix_memalign(&mem, CACHE_LINE, sizeof(w128_t)
+		       * ((size_t)count * (tables + 1) * n + n)) != 0) {
+	free(shared->slots);
+	free(shared);
+	return NULL;
+    }
+    tables_mem = mem;
+    memset(shared->slots, 0, sizeof(shared_slot) * count);
+    for (i = 0; i < count; i++) {
+	shared->slots[i].block = tables_mem + (size_t)i * tables * n;
+	shared->slots[i].state = tables_mem + (size_t)count * tables * n
+	    + (size_t)i * n;
+    }
+    shared->first = tables_mem + (size_t)count * (tables + 1) * n;
+    memcpy(shared->first, sfmt->state, sizeof(w128_t) * n);
+    shared->cursor = sfmt->idx;
+    shared->origin = sfmt->idx;
+    shared->params = sfmt->params;
+    shared->count = count;
+    shared->size = tables * n;
+    shared->size32 = tables * n * 4;
+    return shared;
+}
+
+/**
+ * This function frees a shared generator, after all the threads are
+ * done with it.  The generator it was made from, if given, is set to go
+ * on from the next unclaimed output.
+ * @param shared the shared generator, or NULL
+ * @param sfmt the generator the shared generator was made from, or
+ * NULL
+ */
+void sfmt_free_shared(sfmt_shared *shared, sfmt_t *sfmt) {
+    int n32, off;
+    uint64_t b, p;
+    const w128_t *table;
+    const shared_slot *slot;
+
+    if (shared == NULL) {
+	return;
+    }
+    if (sfmt != NULL && sfmt->params == shared->params) {
+	n32 = shared->params->n32;
+	p = shared->cursor;
+	if (p < (uint64_t)n32) {
+	    table = shared->first;
+	    sfmt->idx = (int)p;
+	} else {
+	    b = (p - n32) / shared->size32;
+	    off = (int)((p - n32) % shared->size32);
+	    slot = &shared->slots[b % shared->count];
+	    if (slot->epoch == b + 1) {
+		table = slot->block + (size_t)(off / n32) * shared->params->n;
+		sfmt->idx = off % n32;
+	    } else {
+		/* nothing of the block is claimed, the end of the one
+		   before */
+		table = b == 0 ? shared->first
+		    : shared->slots[(b - 1) % shared->count].block
+		    + shared->size - shared->params->n;
+		sfmt->idx = n32;
+	    }
+	}
+	memcpy(sfmt->state, table, sizeof(w128_t) * shared->params->n);
+    }
+    free(shared->slots[0].block);
+    free(shared->slots);
+    free(shared);
+}
+
+/**
+ * This function claims the next size outputs of the stream of a shared
+ * generator and copies them into an array, making the blocks of the
+ * range which start in it.  Any number of threads may call this at
+ * once; each gets a range of its own, and the ranges of all the calls
+ * make up the stream of sfmt_next32() of the generator it was made
+ * from.  One claim by an atomic fetch-add is taken a call, so a thread
+ * should claim hundreds of outputs at a time rather than a few.
+ * @param shared the shared generator
+ * @param array an array where the pseudorandom 32-bit integers are
+ * stored
+ * @param size the number of the 32-bit pseudorandom integers, at least
+ * 0
+ * @return the position in the stream of the first output claimed, 0
+ * for the next output of the generator the shared generator was made
+ * from
+ */
+uint64_t sfmt_shared_fill_array32(sfmt_shared *shared, uint32_t *array,
+				  int size) {
+    uint64_t pos, p, end, b;
+    int n32 = shared->params->n32;
+    int off, k;
+    shared_slot *slot;
+
+    pos = __atomic_fetch_add(&shared->cursor, (uint64_t)size,
+			     __ATOMIC_RELAXED);
+    end = pos + size;
+    p = pos;
+    if (p < (uint64_t)n32 && p < end) {
+	k = (int)((end < (uint64_t)n32 ? end : (uint64_t)n32) - p);
+	memcpy(array, &shared->first[0].u[0] + p, sizeof(uint32_t) * k);
+	array += k;
+	p += k;
+    }
+    while (p < end) {
+	b = (p - n32) / shared->size32;
+	off = (int)((p - n32) % shared->size32);
+	slot = &shared->slots[b % shared->count];
+	if (off == 0) {
+	    make_block(shared, b);
+	} else {
+	    wait_epoch(slot, b + 1);
+	}
+	k = end - p < (uint64_t)(shared->size32 - off)
+	    ? (int)(end - p) : shared->size32 - off;
+	memcpy(array, &slot->block[0].u[0] + off, sizeof(uint32_t) * k);
+	__atomic_fetch_add(&slot->consumed, k, __ATOMIC_RELEASE);
+	array += k;
+	p += k;
+    }
+    return pos - shared->origin;
+}
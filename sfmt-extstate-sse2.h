@@ -0,0 +1,344 @@
+/* This file is a part of sfmt-extstate */
+
+/**
+ * @file  sfmt-extstate-sse2.h
+ * @brief SFMT single-stream table functions with 128-bit SSE2
+ * registers, included by the SSE2, AVX2 and AVX-512 backends
+ *
+ * @author Mutsuo Saito (Hiroshima University)
+ * @author Makoto Matsumoto (Hiroshima University)
+ * @author Kenji Rikitake
+ *
+ * Copyright (C) 2006,2007 Mutsuo Saito, Makoto Matsumoto and Hiroshima
+ * University. All rights reserved.
+ *
+ * Copyright (C) 2010 Kenji Rikitake. All rights reserved.
+ *
+ * The new BSD License is applied to this software, see LICENSE.txt
+ *
+ * @note The AVX2 backend compiles these functions VEX-encoded.  The
+ * AVX-512 backend defines mm_recursion() and mm_recursion_reverse()
+ * with VPTERNLOGD before including this file, and the SSE2 ones are
+ * left out when HAVE_AVX512 is defined.
+ */
+
+#ifndef SFMT_EXTSTATE_SSE2_H
+#define SFMT_EXTSTATE_SSE2_H
+
+/* SSE2-specific prototypes */
+#if !defined(HAVE_AVX512)
+PRE_ALWAYS __m128i mm_recursion(__m128i *a, __m128i *b, __m128i c,
+				   __m128i d, __m128i mask) ALWAYSINLINE;
+PRE_ALWAYS __m128i mm_recursion_reverse(__m128i *a, __m128i *b, __m128i c,
+					__m128i d, __m128i mask) ALWAYSINLINE;
+#endif
+PRE_ALWAYS void mm_store_double(double *p, __m128i r) ALWAYSINLINE;
+PRE_ALWAYS void mm_store_float(float *p, __m128i r) ALWAYSINLINE;
+
+/* public functions for the state tables */
+inline void gen_rand_all(w128_t *intstate);
+inline void gen_rand_all_reverse(w128_t *intstate);
+inline void gen_rand_slice(w128_t *next, w128_t *intstate, int start,
+			   int size);
+inline void gen_rand_array(w128_t *array, int size, w128_t *intstate);
+inline void gen_rand_all_double(w128_t *intstate, double *array);
+inline void gen_rand_all_float(w128_t *intstate, float *array);
+
+/* SSE2 assembly language code */
+
+#if !defined(HAVE_AVX512)
+/**
+ * This function represents the recursion formula.
+ * @param a a 128-bit part of the interal state array
+ * @param b a 128-bit part of the interal state array
+ * @param c a 128-bit part of the interal state array
+ * @param d a 128-bit part of the interal state array
+ * @param mask 128-bit mask
+ * @return output
+ */
+PRE_ALWAYS __m128i mm_recursion(__m128i *a, __m128i *b, 
+				   __m128i c, __m128i d, __m128i mask) {
+    __m128i v, x, y, z;
+    
+    x = _mm_load_si128(a);
+    y = _mm_srli_epi32(*b, SR1);
+    z = _mm_srli_si128(c, SR2);
+    v = _mm_slli_epi32(d, SL1);
+    z = _mm_xor_si128(z, x);
+    z = _mm_xor_si128(z, v);
+    x = _mm_slli_si128(x, SL2);
+    y = _mm_and_si128(y, mask);
+    z = _mm_xor_si128(z, x);
+    z = _mm_xor_si128(z, y);
+    return z;
+}
+
+/**
+ * This function represents the recursion formula solved for a.  The
+ * term a ^ (a << SL2 bytes) is inverted by the product of the terms
+ * 1 + L^(2^j), where L is the shift by SL2 bytes, until the shift
+ * reaches 128 bits.
+ * @param a the output of the recursion
+ * @param b a 128-bit part of the interal state array
+ * @param c a 128-bit part of the interal state array
+ * @param d a 128-bit part of the interal state array
+ * @param mask 128-bit mask
+ * @return the 128-bit integer before the recursion
+ */
+PRE_ALWAYS __m128i mm_recursion_reverse(__m128i *a, __m128i *b,
+					__m128i c, __m128i d, __m128i mask) {
+    __m128i v, x, y, z;
+
+    x = _mm_load_si128(a);
+    y = _mm_srli_epi32(*b, SR1);
+    z = _mm_srli_si128(c, SR2);
+    v = _mm_slli_epi32(d, SL1);
+    z = _mm_xor_si128(z, x);
+    z = _mm_xor_si128(z, v);
+    y = _mm_and_si128(y, mask);
+    z = _mm_xor_si128(z, y);
+    z = _mm_xor_si128(z, _mm_slli_si128(z, SL2));
+#if SL2 * 2 < 16
+    z = _mm_xor_si128(z, _mm_slli_si128(z, SL2 * 2));
+#endif
+#if SL2 * 4 < 16
+    z = _mm_xor_si128(z, _mm_slli_si128(z, SL2 * 4));
+#endif
+#if SL2 * 8 < 16
+    z = _mm_xor_si128(z, _mm_slli_si128(z, SL2 * 8));
+#endif
+    return z;
+}
+#endif
+
+/**
+ * This function fills the internal state array with pseudorandom
+ * integers.
+ * @param intstate internal state array
+ */
+inline void gen_rand_all(w128_t *intstate) {
+    int i;
+    __m128i r, r1, r2, mask;
+    mask = _mm_set_epi32(MSK4, MSK3, MSK2, MSK1);
+
+    r1 = _mm_load_si128(&intstate[N - 2].si);
+    r2 = _mm_load_si128(&intstate[N - 1].si);
+    for (i = 0; i < N - POS1; i++) {
+	r = mm_recursion(&intstate[i].si, &intstate[i + POS1].si, r1, r2, mask);
+	_mm_store_si128(&intstate[i].si, r);
+	r1 = r2;
+	r2 = r;
+    }
+    for (; i < N; i++) {
+	r = mm_recursion(&intstate[i].si, &intstate[i + POS1 - N].si, r1, r2, mask);
+	_mm_store_si128(&intstate[i].si, r);
+	r1 = r2;
+	r2 = r;
+    }
+}
+
+/**
+ * This function restores the internal state array from before the
+ * last call of gen_rand_all(), so that the previous block is made again
+ * by gen_rand_all() afterwards.  The recursion is undone from the last
+ * 128-bit integer to the first, when the integers after each one are
+ * already restored and those before it are not yet.
+ * @param intstate internal state array
+ */
+inline void gen_rand_all_reverse(w128_t *intstate) {
+    int i;
+    __m128i r, mask;
+    mask = _mm_set_epi32(MSK4, MSK3, MSK2, MSK1);
+
+    for (i = N - 1; i >= N - POS1; i--) {
+	r = mm_recursion_reverse(&intstate[i].si, &intstate[i + POS1 - N].si,
+				 intstate[i - 2].si, intstate[i - 1].si, mask);
+	_mm_store_si128(&intstate[i].si, r);
+    }
+    for (; i >= 2; i--) {
+	r = mm_recursion_reverse(&intstate[i].si, &intstate[i + POS1].si,
+				 intstate[i - 2].si, intstate[i - 1].si, mask);
+	_mm_store_si128(&intstate[i].si, r);
+    }
+    r = mm_recursion_reverse(&intstate[1].si, &intstate[1 + POS1].si,
+			     intstate[N - 1].si, intstate[0].si, mask);
+    _mm_store_si128(&intstate[1].si, r);
+    r = mm_recursion_reverse(&intstate[0].si, &intstate[POS1].si,
+			     intstate[N - 2].si, intstate[N - 1].si, mask);
+    _mm_store_si128(&intstate[0].si, r);
+}
+
+/**
+ * This function fills size 128-bit integers of the state table after
+ * intstate, from the integer start, into next; the integers before
+ * start must be there already.  A call of size N from 0 makes the
+ * table of gen_rand_all() without changing intstate, and smaller ones
+ * spread the recursion over the reads of intstate.
+ * @param next the next state table being made
+ * @param intstate internal state array
+ * @param start the first 128-bit integer to fill
+ * @param size the number of 128-bit integers to fill
+ */
+inline void gen_rand_slice(w128_t *next, w128_t *intstate, int start,
+			   int size) {
+    int i = start;
+    int end = start + size;
+    __m128i r, r1, r2, mask;
+    mask = _mm_set_epi32(MSK4, MSK3, MSK2, MSK1);
+
+    r1 = _mm_load_si128(i >= 2 ? &next[i - 2].si : &intstate[N - 2 + i].si);
+    r2 = _mm_load_si128(i >= 1 ? &next[i - 1].si : &intstate[N - 1].si);
+    for (; i < end && i < N - POS1; i++) {
+	r = mm_recursion(&intstate[i].si, &intstate[i + POS1].si, r1, r2, mask);
+	_mm_store_si128(&next[i].si, r);
+	r1 = r2;
+	r2 = r;
+    }
+    for (; i < end; i++) {
+	r = mm_recursion(&intstate[i].si, &next[i + POS1 - N].si, r1, r2, mask);
+	_mm_store_si128(&next[i].si, r);
+	r1 = r2;
+	r2 = r;
+    }
+}
+
+/**
+ * This function fills the user-specified array with pseudorandom
+ * integers.
+ *
+ * @param array an 128-bit array to be filled by pseudorandom numbers.  
+ * @param size number of 128-bit pesudorandom numbers to be generated.
+ * @param intstate internal state array
+ */
+inline void gen_rand_array(w128_t *array, int size, w128_t *intstate) {
+    int i, j;
+    __m128i r, r1, r2, mask;
+    mask = _mm_set_epi32(MSK4, MSK3, MSK2, MSK1);
+
+    r1 = _mm_load_si128(&intstate[N - 2].si);
+    r2 = _mm_load_si128(&intstate[N - 1].si);
+    for (i = 0; i < N - POS1; i++) {
+	r = mm_recursion(&intstate[i].si, &intstate[i + POS1].si, r1, r2, mask);
+	_mm_store_si128(&array[i].si, r);
+	r1 = r2;
+	r2 = r;
+    }
+    for (; i < N; i++) {
+	r = mm_recursion(&intstate[i].si, &array[i + POS1 - N].si, r1, r2, mask);
+	_mm_store_si128(&array[i].si, r);
+	r1 = r2;
+	r2 = r;
+    }
+    /* main loop */
+    for (; i < size - N; i++) {
+	r = mm_recursion(&array[i - N].si, &array[i + POS1 - N].si, r1, r2,
+			 mask);
+	_mm_store_si128(&array[i].si, r);
+	r1 = r2;
+	r2 = r;
+    }
+    for (j = 0; j < 2 * N - size; j++) {
+	r = _mm_load_si128(&array[j + size - N].si);
+	_mm_store_si128(&intstate[j].si, r);
+    }
+    for (; i < size; i++) {
+	r = mm_recursion(&array[i - N].si, &array[i + POS1 - N].si, r1, r2,
+			 mask);
+	_mm_store_si128(&array[i].si, r);
+	_mm_store_si128(&intstate[j++].si, r);
+	r1 = r2;
+	r2 = r;
+    }
+}
+
+/**
+ * This function converts the two 64-bit integers of a 128-bit register
+ * into two doubles in [0, 1) and stores them: the upper 52 bits are set
+ * as the fraction of a double in [1, 2), and 1 is subtracted, which is
+ * exact.
+ * @param p where the doubles are stored, of any alignment
+ * @param r 128-bit register
+ */
+PRE_ALWAYS void mm_store_double(double *p, __m128i r) {
+    __m128i x;
+
+    x = _mm_or_si128(_mm_srli_epi64(r, 12),
+		     _mm_set_epi32(0x3ff00000, 0, 0x3ff00000, 0));
+    _mm_storeu_pd(p, _mm_sub_pd(_mm_castsi128_pd(x), _mm_set1_pd(1.0)));
+}
+
+/**
+ * This function converts the four 32-bit integers of a 128-bit
+ * register into four floats in [0, 1) and stores them, in the same
+ * way as mm_store_double() with the upper 23 bits.
+ * @param p where the floats are stored, of any alignment
+ * @param r 128-bit register
+ */
+PRE_ALWAYS void mm_store_float(float *p, __m128i r) {
+    __m128i x;
+
+    x = _mm_or_si128(_mm_srli_epi32(r, 9), _mm_set1_epi32(0x3f800000));
+    _mm_storeu_ps(p, _mm_sub_ps(_mm_castsi128_ps(x), _mm_set1_ps(1.0f)));
+}
+
+/**
+ * This function fills the internal state array with pseudorandom
+ * integers, and converts each 128-bit integer into two double precision
+ * floating point numbers in [0, 1) in the register, in the same pass.
+ * @param intstate internal state array
+ * @param array an array of N * 2 doubles to be filled
+ */
+inline void gen_rand_all_double(w128_t *intstate, double *array) {
+    int i;
+    __m128i r, r1, r2, mask;
+    mask = _mm_set_epi32(MSK4, MSK3, MSK2, MSK1);
+
+    r1 = _mm_load_si128(&intstate[N - 2].si);
+    r2 = _mm_load_si128(&intstate[N - 1].si);
+    for (i = 0; i < N - POS1; i++) {
+	r = mm_recursion(&intstate[i].si, &intstate[i + POS1].si, r1, r2, mask);
+	_mm_store_si128(&intstate[i].si, r);
+	mm_store_double(&array[i * 2], r);
+	r1 = r2;
+	r2 = r;
+    }
+    for (; i < N; i++) {
+	r = mm_recursion(&intstate[i].si, &intstate[i + POS1 - N].si, r1, r2, mask);
+	_mm_store_si128(&intstate[i].si, r);
+	mm_store_double(&array[i * 2], r);
+	r1 = r2;
+	r2 = r;
+    }
+}
+
+/**
+ * This function fills the internal state array with pseudorandom
+ * integers, and converts each 128-bit integer into four single precision
+ * floating point numbers in [0, 1) in the register, in the same pass.
+ * @param intstate internal state array
+ * @param array an array of N * 4 floats to be filled
+ */
+inline void gen_rand_all_float(w128_t *intstate, float *array) {
+    int i;
+    __m128i r, r1, r2, mask;
+    mask = _mm_set_epi32(MSK4, MSK3, MSK2, MSK1);
+
+    r1 = _mm_load_si128(&intstate[N - 2].si);
+    r2 = _mm_load_si128(&intstate[N - 1].si);
+    for (i = 0; i < N - POS1; i++) {
+	r = mm_recursion(&intstate[i].si, &intstate[i + POS1].si, r1, r2, mask);
+	_mm_store_si128(&intstate[i].si, r);
+	mm_store_float(&array[i * 4], r);
+	r1 = r2;
+	r2 = r;
+    }
+    for (; i < N; i++) {
+	r = mm_recursion(&intstate[i].si, &intstate[i + POS1 - N].si, r1, r2, mask);
+	_mm_store_si128(&intstate[i].si, r);
+	mm_store_float(&array[i * 4], r);
+	r1 = r2;
+	r2 = r;
+    }
+}
+
+#endif /* SFMT_EXTSTATE_SSE2_H */
@@ -17,6 +17,7 @@
  */
 #include <string.h>
 #include <assert.h>
+#include "sfmt-params.h"
 #include "sfmt-extstate.h"
 
 /* non-SSE2-specific prototypes */
@@ -24,10 +25,23 @@ inline void rshift128(w128_t *out,  w128_t const *in, int shift);
 inline void lshift128(w128_t *out,  w128_t const *in, int shift);
 inline void do_recursion(w128_t *r, w128_t *a, w128_t *b, w128_t *c,
 			 w128_t *d);
+inline void undo_recursion(w128_t *r, w128_t *a, w128_t *b, w128_t *c,
+			   w128_t *d);
+inline void convert_double(double *p, w128_t *r);
+inline void convert_float(float *p, w128_t *r);
 
 /* public functions for the state tables */
 inline void gen_rand_all(w128_t *intstate);
+inline void gen_rand_all_reverse(w128_t *intstate);
+inline void gen_rand_slice(w128_t *next, w128_t *intstate, int start,
+			   int size);
 inline void gen_rand_array(w128_t *array, int size, w128_t *intstate);
+inline void gen_rand_all_double(w128_t *intstate, double *array);
+inline void gen_rand_all_float(w128_t *intstate, float *array);
+void gen_rand_all_x2(w128_t *intstate[2]);
+void gen_rand_array_x2(w128_t *array[2], int size, w128_t *intstate[2]);
+void gen_rand_all_x4(w128_t *intstate[4]);
+void gen_rand_array_x4(w128_t *array[4], int size, w128_t *intstate[4]);
 
 /**
  * This function simulates SIMD 128-bit right shift by the standard C.
@@ -101,6 +115,44 @@ inline void do_recursion(w128_t *r, w128_t *a, w128_t *b, w128_t *c,
 	^ (d->u[3] << SL1);
 }
 
+/**
+ * This function represents the recursion formula solved for a.  The
+ * term a ^ (a << SL2 bytes) is inverted by the product of the terms
+ * 1 + L^(2^j), where L is the shift by SL2 bytes, until the shift
+ * reaches 128 bits.
+ * @param r output, the 128-bit integer before the recursion
+ * @param a the output of the recursion
+ * @param b a 128-bit part of the internal state array
+ * @param c a 128-bit part of the internal state array
+ * @param d a 128-bit part of the internal state array
+ */
+inline void undo_recursion(w128_t *r, w128_t *a, w128_t *b, w128_t *c,
+			   w128_t *d) {
+    w128_t y;
+    uint64_t th, tl;
+    int shift;
+
+    rshift128(&y, c, SR2);
+    y.u[0] ^= a->u[0] ^ ((b->u[0] >> SR1) & MSK1) ^ (d->u[0] << SL1);
+    y.u[1] ^= a->u[1] ^ ((b->u[1] >> SR1) & MSK2) ^ (d->u[1] << SL1);
+    y.u[2] ^= a->u[2] ^ ((b->u[2] >> SR1) & MSK3) ^ (d->u[2] << SL1);
+    y.u[3] ^= a->u[3] ^ ((b->u[3] >> SR1) & MSK4) ^ (d->u[3] << SL1);
+    th = ((uint64_t)y.u[3] << 32) | ((uint64_t)y.u[2]);
+    tl = ((uint64_t)y.u[1] << 32) | ((uint64_t)y.u[0]);
+    for (shift = SL2 * 8; shift < 128; shift *= 2) {
+	if (shift < 64) {
+	    th ^= (th << shift) | (tl >> (64 - shift));
+	    tl ^= tl << shift;
+	} else {
+	    th ^= tl << (shift - 64);
+	}
+    }
+    r->u[1] = (uint32_t)(tl >> 32);
+    r->u[0] = (uint32_t)tl;
+    r->u[3] = (uint32_t)(th >> 32);
+    r->u[2] = (uint32_t)th;
+}
+
 /**
  * This function fills the internal state array with pseudorandom
  * integers.
@@ -124,6 +176,62 @@ inline void gen_rand_all(w128_t *intstate) {
     }
 }
 
+/**
+ * This function restores the internal state array from before the
+ * last call of gen_rand_all(), so that the previous block is made again
+ * by gen_rand_all() afterwards.  The recursion is undone from the last
+ * 128-bit integer to the first, when the integers after each one are
+ * already restored and those before it are not yet.
+ * @param intstate internal state array
+ */
+inline void gen_rand_all_reverse(w128_t *intstate) {
+    int i;
+
+    for (i = N - 1; i >= N - POS1; i--) {
+	undo_recursion(&intstate[i], &intstate[i], &intstate[i + POS1 - N],
+		       &intstate[i - 2], &intstate[i - 1]);
+    }
+    for (; i >= 2; i--) {
+	undo_recursion(&intstate[i], &intstate[i], &intstate[i + POS1],
+		       &intstate[i - 2], &intstate[i - 1]);
+    }
+    undo_recursion(&intstate[1], &intstate[1], &intstate[1 + POS1],
+		   &intstate[N - 1], &intstate[0]);
+    undo_recursion(&intstate[0], &intstate[0], &intstate[POS1],
+		   &intstate[N - 2], &intstate[N - 1]);
+}
+
+/**
+ * This function fills size 128-bit integers of the state table after
+ * intstate, from the integer start, into next; the integers before
+ * start must be there already.  A call of size N from 0 makes the
+ * table of gen_rand_all() without changing intstate, and smaller ones
+ * spread the recursion over the reads of intstate.
+ * @param next the next state table being made
+ * @param intstate internal state array
+ * @param start the first 128-bit integer to fill
+ * @param size the number of 128-bit integers to fill
+ */
+inline void gen_rand_slice(w128_t *next, w128_t *intstate, int start,
+			   int size) {
+    int i = start;
+    int end = start + size;
+    w128_t *r1, *r2;
+
+    r1 = i >= 2 ? &next[i - 2] : &intstate[N - 2 + i];
+    r2 = i >= 1 ? &next[i - 1] : &intstate[N - 1];
+    for (; i < end && i < N - POS1; i++) {
+	do_recursion(&next[i], &intstate[i], &intstate[i + POS1], r1, r2);
+	r1 = r2;
+	r2 = &next[i];
+    }
+    for (; i < end; i++) {
+	do_recursion(&next[i], &intstate[i], &next[i + POS1 - N], r1, r2);
+	r1 = r2;
+	r2 = &next[i];
+    }
+}
+
 /**
  * This function fills the user-specified array with pseudorandom
  * integers.
@@ -163,3 +271,141 @@ inline void gen_rand_array(w128_t *array, int size, w128_t *intstate) {
 	intstate[j] = array[i];
     }
 }
+
+/**
+ * This function converts the two 64-bit integers of a 128-bit integer
+ * into two doubles in [0, 1), with their upper 52 bits.  The result is
+ * the same as that of the SIMD backends.
+ * @param p where the doubles are stored
+ * @param r 128-bit integer
+ */
+inline void convert_double(double *p, w128_t *r) {
+    p[0] = (double)((((uint64_t)r->u[1] << 32) | r->u[0]) >> 12)
+	* (1.0 / 4503599627370496.0);
+    p[1] = (double)((((uint64_t)r->u[3] << 32) | r->u[2]) >> 12)
+	* (1.0 / 4503599627370496.0);
+}
+
+/**
+ * This function converts the four 32-bit integers of a 128-bit integer
+ * into four floats in [0, 1), with their upper 23 bits.  The result is
+ * the same as that of the SIMD backends.
+ * @param p where the floats are stored
+ * @param r 128-bit integer
+ */
+inline void convert_float(float *p, w128_t *r) {
+    p[0] = (float)(r->u[0] >> 9) * (1.0f / 8388608.0f);
+    p[1] = (float)(r->u[1] >> 9) * (1.0f / 8388608.0f);
+    p[2] = (float)(r->u[2] >> 9) * (1.0f / 8388608.0f);
+    p[3] = (float)(r->u[3] >> 9) * (1.0f / 8388608.0f);
+}
+
+/**
+ * This function fills the internal state array with pseudorandom
+ * integers, and converts each 128-bit integer into two double precision
+ * floating point numbers in [0, 1) in the same pass.
+ * @param intstate internal state array
+ * @param array an array of N * 2 doubles to be filled
+ */
+inline void gen_rand_all_double(w128_t *intstate, double *array) {
+    int i;
+    w128_t *r1, *r2;
+
+    r1 = &intstate[N - 2];
+    r2 = &intstate[N - 1];
+    for (i = 0; i < N - POS1; i++) {
+	do_recursion(&intstate[i], &intstate[i], &intstate[i + POS1], r1, r2);
+	convert_double(&array[i * 2], &intstate[i]);
+	r1 = r2;
+	r2 = &intstate[i];
+    }
+    for (; i < N; i++) {
+	do_recursion(&intstate[i], &intstate[i], &intstate[i + POS1 - N], r1, r2);
+	convert_double(&array[i * 2], &intstate[i]);
+	r1 = r2;
+	r2 = &intstate[i];
+    }
+}
+
+/**
+ * This function fills the internal state array with pseudorandom
+ * integers, and converts each 128-bit integer into four single precision
+ * floating point numbers in [0, 1) in the same pass.
+ * @param intstate internal state array
+ * @param array an array of N * 4 floats to be filled
+ */
+inline void gen_rand_all_float(w128_t *intstate, float *array) {
+    int i;
+    w128_t *r1, *r2;
+
+    r1 = &intstate[N - 2];
+    r2 = &intstate[N - 1];
+    for (i = 0; i < N - POS1; i++) {
+	do_recursion(&intstate[i], &intstate[i], &intstate[i + POS1], r1, r2);
+	convert_float(&array[i * 4], &intstate[i]);
+	r1 = r2;
+	r2 = &intstate[i];
+    }
+    for (; i < N; i++) {
+	do_recursion(&intstate[i], &intstate[i], &intstate[i + POS1 - N], r1, r2);
+	convert_float(&array[i * 4], &intstate[i]);
+	r1 = r2;
+	r2 = &intstate[i];
+    }
+}
+
+/**
+ * This function fills two internal state arrays with pseudorandom
+ * integers, one stream after another.
+ * @param intstate internal state arrays of the two streams
+ */
+void gen_rand_all_x2(w128_t *intstate[2]) {
+    gen_rand_all(intstate[0]);
+    gen_rand_all(intstate[1]);
+}
+
+/**
+ * This function fills two user-specified arrays with pseudorandom
+ * integers, one stream after another.
+ *
+ * @param array 128-bit arrays of the two streams to be filled by
+ * pseudorandom numbers.
+ * @param size number of 128-bit pseudorandom numbers to be generated
+ * for each stream.
+ * @param intstate internal state arrays of the two streams
+ */
+void gen_rand_array_x2(w128_t *array[2], int size, w128_t *intstate[2]) {
+    gen_rand_array(array[0], size, intstate[0]);
+    gen_rand_array(array[1], size, intstate[1]);
+}
+
+/**
+ * This function fills four internal state arrays with pseudorandom
+ * integers, one stream after another.
+ * @param intstate internal state arrays of the four streams
+ */
+void gen_rand_all_x4(w128_t *intstate[4]) {
+    int k;
+
+    for (k = 0; k < 4; k++) {
+	gen_rand_all(intstate[k]);
+    }
+}
+
+/**
+ * This function fills four user-specified arrays with pseudorandom
+ * integers, one stream after another.
+ *
+ * @param array 128-bit arrays of the four streams to be filled by
+ * pseudorandom numbers.
+ * @param size number of 128-bit pseudorandom numbers to be generated
+ * for each stream.
+ * @param intstate internal state arrays of the four streams
+ */
+void gen_rand_array_x4(w128_t *array[4], int size, w128_t *intstate[4]) {
+    int k;
+
+    for (k = 0; k < 4; k++) {
+	gen_rand_array(array[k], size, intstate[k]);
+    }
+}
@@ -36,7 +36,6 @@
 #define SFMT_EXTSTATE_H
 
 #include <stdio.h>
-#include "sfmt-params-M19937.h"
 
 #if defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 199901L)
   #include <inttypes.h>
@@ -46,7 +45,7 @@
   #define inline __inline
 #else
   #include <inttypes.h>
-  #if defined(__GNUC__)
+  #if defined(__GNUC__) && !defined(__cplusplus)
     #define inline __inline__
   #endif
 #endif
@@ -81,7 +80,11 @@
   128-bit SIMD data type for SSE2 or standard C
   ------------------------------------------------------*/
 #if defined(HAVE_SSE2)
-  #include <emmintrin.h>
+  #if defined(HAVE_AVX2) || defined(HAVE_AVX512)
+    #include <immintrin.h>
+  #else
+    #include <emmintrin.h>
+  #endif
 
 /** 128-bit data structure */
 union W128_T {
@@ -102,13 +105,622 @@ typedef struct W128_T w128_t;
 
 #endif /* HAVE_SSE2 */
 
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/*------------------------------------------------------
+  function names for the run-time dispatching
+  ------------------------------------------------------*/
+/** concatenates a function name and a suffix */
+#define SFMT_CAT_(a, b) a##_##b
+/** concatenates a function name and a suffix, after expansion */
+#define SFMT_CAT(a, b) SFMT_CAT_(a, b)
+/** pastes two tokens */
+#define SFMT_PASTE_(a, b) a##b
+/** pastes two tokens, after expansion */
+#define SFMT_PASTE(a, b) SFMT_PASTE_(a, b)
+/** name of a function of a backend for a Mersenne exponent */
+#define SFMT_BACKEND_NAME(func, backend, mexp) func##_##backend##_M##mexp
+
+/** the Mersenne exponents of libsfmt-extstate.a */
+#define SFMT_MEXP_LIST(X)						\
+    X(607) X(1279) X(2281) X(4253) X(11213) X(19937) X(44497)		\
+    X(86243) X(132049) X(216091)
+
+#if defined(SFMT_DISPATCH)
+/** declares the table functions of a backend linked for dispatching */
+#define SFMT_DECLARE_BACKEND(backend, mexp)				\
+    void SFMT_BACKEND_NAME(gen_rand_all, backend, mexp)(w128_t *intstate); \
+    void SFMT_BACKEND_NAME(gen_rand_all_reverse, backend, mexp)(		\
+					w128_t *intstate);		\
+    void SFMT_BACKEND_NAME(gen_rand_slice, backend, mexp)(		\
+		w128_t *next, w128_t *intstate, int start, int size);	\
+    void SFMT_BACKEND_NAME(gen_rand_array, backend, mexp)(w128_t *array, \
+					int size, w128_t *intstate);	\
+    void SFMT_BACKEND_NAME(gen_rand_all_double, backend, mexp)(		\
+		w128_t *intstate, double *array);			\
+    void SFMT_BACKEND_NAME(gen_rand_all_float, backend, mexp)(		\
+		w128_t *intstate, float *array);			\
+    void SFMT_BACKEND_NAME(gen_rand_all_x2, backend, mexp)(		\
+					w128_t *intstate[2]);		\
+    void SFMT_BACKEND_NAME(gen_rand_array_x2, backend, mexp)(		\
+		w128_t *array[2], int size, w128_t *intstate[2]);	\
+    void SFMT_BACKEND_NAME(gen_rand_all_x4, backend, mexp)(		\
+					w128_t *intstate[4]);		\
+    void SFMT_BACKEND_NAME(gen_rand_array_x4, backend, mexp)(		\
+		w128_t *array[4], int size, w128_t *intstate[4]);
+/** declares the table functions of all the backends */
+#define SFMT_DECLARE_BACKENDS(mexp)					\
+    SFMT_DECLARE_BACKEND(std, mexp)					\
+    SFMT_DECLARE_BACKEND(sse2, mexp)					\
+    SFMT_DECLARE_BACKEND(avx2, mexp)					\
+    SFMT_DECLARE_BACKEND(avx512, mexp)
+
+SFMT_MEXP_LIST(SFMT_DECLARE_BACKENDS)
+#endif /* SFMT_DISPATCH */
+
+/*
+ * A backend compiled with SFMT_BACKEND defined (e.g. -DSFMT_BACKEND=sse2)
+ * exports its table functions with the backend name appended
+ * (e.g. gen_rand_all_sse2), and a file compiled with SFMT_MEXP_NAMES
+ * defined exports or imports the functions with the Mersenne exponent
+ * appended (e.g. gen_rand_all_sse2_M607 or init_gen_rand_M607), so
+ * that all the backends for all the exponents can be linked into one
+ * library.  MEXP must be defined before including this file for
+ * SFMT_MEXP_NAMES.
+ */
+#if defined(SFMT_BACKEND) && defined(SFMT_MEXP_NAMES)
+#define SFMT_NAME(func) \
+    SFMT_CAT(SFMT_CAT(func, SFMT_BACKEND), SFMT_PASTE(M, MEXP))
+#elif defined(SFMT_BACKEND)
+#define SFMT_NAME(func) SFMT_CAT(func, SFMT_BACKEND)
+#elif defined(SFMT_MEXP_NAMES)
+#define SFMT_NAME(func) SFMT_CAT(func, SFMT_PASTE(M, MEXP))
+#endif
+
+#if defined(SFMT_NAME)
+#define gen_rand_all SFMT_NAME(gen_rand_all)
+#define gen_rand_all_reverse SFMT_NAME(gen_rand_all_reverse)
+#define gen_rand_slice SFMT_NAME(gen_rand_slice)
+#define gen_rand_array SFMT_NAME(gen_rand_array)
+#define gen_rand_all_double SFMT_NAME(gen_rand_all_double)
+#define gen_rand_all_float SFMT_NAME(gen_rand_all_float)
+#define gen_rand_all_x2 SFMT_NAME(gen_rand_all_x2)
+#define gen_rand_array_x2 SFMT_NAME(gen_rand_array_x2)
+#define gen_rand_all_x4 SFMT_NAME(gen_rand_all_x4)
+#define gen_rand_array_x4 SFMT_NAME(gen_rand_array_x4)
+#define period_certification SFMT_NAME(period_certification)
+#define get_idstring SFMT_NAME(get_idstring)
+#define get_min_array_size32 SFMT_NAME(get_min_array_size32)
+#define get_min_array_size64 SFMT_NAME(get_min_array_size64)
+#define init_gen_rand SFMT_NAME(init_gen_rand)
+#define init_by_array SFMT_NAME(init_by_array)
+#endif /* SFMT_NAME */
+
 /* public functions for the state tables */
 void gen_rand_all(w128_t *intstate);
+void gen_rand_all_reverse(w128_t *intstate);
+void gen_rand_slice(w128_t *next, w128_t *intstate, int start, int size);
 void gen_rand_array(w128_t *array, int size, w128_t *intstate);
+void gen_rand_all_double(w128_t *intstate, double *array);
+void gen_rand_all_float(w128_t *intstate, float *array);
 void period_certification(w128_t *intstate);
 const char *get_idstring(void);
 int get_min_array_size32(void);
+int get_min_array_size64(void);
 void init_gen_rand(uint32_t seed, w128_t *intstate);
 void init_by_array(uint32_t *init_key, int key_length, w128_t *intstate);
 
+/* public functions for the state tables of multiple streams */
+void gen_rand_all_x2(w128_t *intstate[2]);
+void gen_rand_array_x2(w128_t *array[2], int size, w128_t *intstate[2]);
+void gen_rand_all_x4(w128_t *intstate[4]);
+void gen_rand_array_x4(w128_t *array[4], int size, w128_t *intstate[4]);
+
+/** table functions of a backend */
+struct SFMT_KERNELS_T {
+    /** backend name */
+    const char *name;
+    void (*gen_rand_all)(w128_t *intstate);
+    void (*gen_rand_all_reverse)(w128_t *intstate);
+    void (*gen_rand_slice)(w128_t *next, w128_t *intstate, int start,
+			   int size);
+    void (*gen_rand_array)(w128_t *array, int size, w128_t *intstate);
+    void (*gen_rand_all_double)(w128_t *intstate, double *array);
+    void (*gen_rand_all_float)(w128_t *intstate, float *array);
+    void (*gen_rand_all_x2)(w128_t *intstate[2]);
+    void (*gen_rand_array_x2)(w128_t *array[2], int size,
+			      w128_t *intstate[2]);
+    void (*gen_rand_all_x4)(w128_t *intstate[4]);
+    void (*gen_rand_array_x4)(w128_t *array[4], int size,
+			      w128_t *intstate[4]);
+};
+/** table functions of a backend */
+typedef struct SFMT_KERNELS_T sfmt_kernels_t;
+
+/* public functions for the run-time backend selection */
+const sfmt_kernels_t *sfmt_get_kernels(void);
+const char *sfmt_get_backend(void);
+int sfmt_set_backend(const char *name);
+
+/*------------------------------------------------------
+  parameter set descriptors of libsfmt-extstate.a
+  ------------------------------------------------------*/
+/** a parameter set of SFMT and its functions */
+struct SFMT_PARAMS_T {
+    /** Mersenne exponent */
+    int mexp;
+    /** size of the internal state array in 128-bit integers */
+    int n;
+    /** size of the internal state array in 32-bit integers */
+    int n32;
+    /** the pick up position of the array */
+    int pos1;
+    /** the parameters of the shifts */
+    int sl1, sl2, sr1, sr2;
+    /** the bitmask used in the recursion */
+    uint32_t msk[4];
+    /** the 128-bit period certification vector */
+    uint32_t parity[4];
+    /** identification string */
+    const char *idstr;
+    /* the table functions, with the backend selected at run time */
+    void (*gen_rand_all)(w128_t *intstate);
+    void (*gen_rand_all_reverse)(w128_t *intstate);
+    void (*gen_rand_slice)(w128_t *next, w128_t *intstate, int start,
+			   int size);
+    void (*gen_rand_array)(w128_t *array, int size, w128_t *intstate);
+    void (*gen_rand_all_double)(w128_t *intstate, double *array);
+    void (*gen_rand_all_float)(w128_t *intstate, float *array);
+    void (*gen_rand_all_x2)(w128_t *intstate[2]);
+    void (*gen_rand_array_x2)(w128_t *array[2], int size,
+			      w128_t *intstate[2]);
+    void (*gen_rand_all_x4)(w128_t *intstate[4]);
+    void (*gen_rand_array_x4)(w128_t *array[4], int size,
+			      w128_t *intstate[4]);
+    void (*period_certification)(w128_t *intstate);
+    void (*init_gen_rand)(uint32_t seed, w128_t *intstate);
+    void (*init_by_array)(uint32_t *init_key, int key_length,
+			  w128_t *intstate);
+};
+/** a parameter set of SFMT and its functions */
+typedef struct SFMT_PARAMS_T sfmt_params_t;
+
+/** declares the parameter set descriptor of a Mersenne exponent */
+#define SFMT_DECLARE_PARAMS(mexp) extern const sfmt_params_t sfmt_params_M##mexp;
+SFMT_MEXP_LIST(SFMT_DECLARE_PARAMS)
+
+const sfmt_params_t *sfmt_get_params(int mexp);
+
+/*------------------------------------------------------
+  generator objects of libsfmt-extstate.a
+  ------------------------------------------------------*/
+/**
+ * a generator: the state table of a parameter set and the cursor of
+ * its output.  The members are only read by the inline functions
+ * below; use the sfmt_* functions to change them.
+ *
+ * The cursor idx counts 32-bit integers, and a 64-bit output is always
+ * the next two 32-bit outputs, the first one in the lower 32 bits.
+ * When idx is even, this is the 64-bit integer of the table at idx / 2
+ * (the 64-bit output of the original SFMT); when idx is odd, e.g. after
+ * an odd number of sfmt_next32() calls, the 64-bit outputs straddle
+ * the 64-bit integers of the table, and may straddle a refill of the
+ * table.  32- and 64-bit outputs can therefore be mixed safely.
+ */
+struct SFMT_T {
+    /** the internal state array, aligned to 64 bytes */
+    w128_t *state;
+    /** the 32-bit integer pointer to the internal state array */
+    uint32_t *state32;
+    /** index of the next unused 32-bit integer of state32 */
+    int idx;
+    /** size of the internal state array in 32-bit integers */
+    int n32;
+    /** the parameter set */
+    const sfmt_params_t *params;
+};
+/** a generator */
+typedef struct SFMT_T sfmt_t;
+
+sfmt_t *sfmt_new(int mexp);
+void sfmt_free(sfmt_t *sfmt);
+void sfmt_init_gen_rand(sfmt_t *sfmt, uint32_t seed);
+void sfmt_init_by_array(sfmt_t *sfmt, uint32_t *init_key, int key_length);
+void sfmt_fill_array32(sfmt_t *sfmt, uint32_t *array, int size);
+void sfmt_fill_array64(sfmt_t *sfmt, uint64_t *array, int size);
+void sfmt_fill_array_double(sfmt_t *sfmt, double *array, int size);
+void sfmt_fill_array_float(sfmt_t *sfmt, float *array, int size);
+void sfmt_fill_array_bounded(sfmt_t *sfmt, uint32_t *array, int size,
+			     uint32_t n);
+void sfmt_fill_array_range(sfmt_t *sfmt, uint32_t *array, int size,
+			   uint32_t lo, uint32_t hi);
+double sfmt_next_normal(sfmt_t *sfmt);
+float sfmt_next_normal_float(sfmt_t *sfmt);
+void sfmt_fill_array_normal(sfmt_t *sfmt, double *array, int size);
+void sfmt_fill_array_normal_float(sfmt_t *sfmt, float *array, int size);
+void sfmt_fill_array32_lanes(sfmt_t *sfmt, uint32_t *lanes[], int count,
+			     int size);
+
+/**
+ * This function generates and returns a 32-bit pseudorandom number.
+ * sfmt_init_gen_rand or sfmt_init_by_array must be called before this
+ * function.
+ * @param sfmt the generator
+ * @return 32-bit pseudorandom number
+ */
+static inline uint32_t sfmt_next32(sfmt_t *sfmt) {
+    if (sfmt->idx >= sfmt->n32) {
+	sfmt->params->gen_rand_all(sfmt->state);
+	sfmt->idx = 0;
+    }
+    return sfmt->state32[sfmt->idx++];
+}
+
+/**
+ * This function generates and returns a 64-bit pseudorandom number,
+ * made of the next two 32-bit pseudorandom numbers, the first one in
+ * the lower 32 bits.
+ * @param sfmt the generator
+ * @return 64-bit pseudorandom number
+ */
+static inline uint64_t sfmt_next64(sfmt_t *sfmt) {
+    uint64_t r;
+    int i = sfmt->idx;
+
+    if (i + 2 <= sfmt->n32) {
+	r = sfmt->state32[i] | ((uint64_t)sfmt->state32[i + 1] << 32);
+	sfmt->idx = i + 2;
+	return r;
+    }
+    r = sfmt_next32(sfmt);
+    return r | ((uint64_t)sfmt_next32(sfmt) << 32);
+}
+
+/**
+ * This function generates and returns a pseudorandom double in [0, 1)
+ * with 52-bit resolution, from the upper 52 bits of sfmt_next64().
+ * It is the same as the output of sfmt_fill_array_double().
+ * @param sfmt the generator
+ * @return double in [0, 1)
+ */
+static inline double sfmt_next_double(sfmt_t *sfmt) {
+    return (double)(sfmt_next64(sfmt) >> 12) * (1.0 / 4503599627370496.0);
+}
+
+/**
+ * This function generates and returns a pseudorandom float in [0, 1)
+ * with 23-bit resolution, from the upper 23 bits of sfmt_next32().
+ * It is the same as the output of sfmt_fill_array_float().
+ * @param sfmt the generator
+ * @return float in [0, 1)
+ */
+static inline float sfmt_next_float(sfmt_t *sfmt) {
+    return (float)(sfmt_next32(sfmt) >> 9) * (1.0f / 8388608.0f);
+}
+
+/**
+ * This function generates and returns an unbiased pseudorandom integer
+ * in [0, n), with a multiplication instead of a division: a 32-bit
+ * output x is rejected only if the lower 32 bits of x * n are less than
+ * 2^32 mod n, which is computed only then.
+ * @param sfmt the generator
+ * @param n the upper bound, exclusive; 0 stands for 2^32
+ * @return integer in [0, n)
+ */
+static inline uint32_t sfmt_next_bounded(sfmt_t *sfmt, uint32_t n) {
+    uint64_t m;
+    uint32_t t;
+
+    if (n == 0) {
+	return sfmt_next32(sfmt);
+    }
+    m = (uint64_t)sfmt_next32(sfmt) * n;
+    if ((uint32_t)m < n) {
+	t = (0U - n) % n;
+	while ((uint32_t)m < t) {
+	    m = (uint64_t)sfmt_next32(sfmt) * n;
+	}
+    }
+    return (uint32_t)(m >> 32);
+}
+
+/**
+ * This function generates and returns an unbiased pseudorandom integer
+ * in [lo, hi].
+ * @param sfmt the generator
+ * @param lo the lower bound, inclusive
+ * @param hi the upper bound, inclusive, not less than lo
+ * @return integer in [lo, hi]
+ */
+static inline uint32_t sfmt_next_range(sfmt_t *sfmt, uint32_t lo,
+				       uint32_t hi) {
+    return lo + sfmt_next_bounded(sfmt, hi - lo + 1);
+}
+
+/*------------------------------------------------------
+  jump-ahead of libsfmt-extstate.a
+  ------------------------------------------------------*/
+/**
+ * a jump polynomial: x^J modulo the minimal polynomial of the
+ * recursion of a parameter set, which moves a state table of the
+ * parameter set J 128-bit integers ahead.
+ */
+struct JUMP_POLY_T {
+    /** the parameter set */
+    const sfmt_params_t *params;
+    /** degree of the polynomial */
+    int degree;
+    /** the coefficient of x^i is the bit i % 64 of coef[i / 64] */
+    const uint64_t *coef;
+};
+/** a jump polynomial */
+typedef struct JUMP_POLY_T jump_poly;
+
+jump_poly *sfmt_new_jump_poly(int mexp, const uint32_t *step,
+			      int step_length);
+void sfmt_free_jump_poly(jump_poly *p);
+int sfmt_jump(w128_t *intstate, const jump_poly *p);
+
+/**
+ * a jump table: the jump polynomials of 2^k 128-bit integers for k =
+ * kmin, ..., kmin + count - 1, mapped from a file of
+ * sfmt_write_jump_table()
+ */
+struct SFMT_JUMP_TABLE_T {
+    /** the parameter set */
+    const sfmt_params_t *params;
+    /** the first power of 2 */
+    int kmin;
+    /** the number of the polynomials */
+    int count;
+    /** the mapped file */
+    void *map;
+    /** size of the mapped file */
+    size_t size;
+    /** the polynomials, pointing into map */
+    jump_poly *polys;
+};
+/** a jump table */
+typedef struct SFMT_JUMP_TABLE_T sfmt_jump_table;
+
+int sfmt_min_poly(const sfmt_params_t *params, uint64_t *poly);
+int sfmt_save_jump_table(const char *path, const sfmt_params_t *params,
+			 int kmin, int count, const uint64_t *coef);
+int sfmt_write_jump_table(const char *path, int mexp, int kmin, int kmax);
+sfmt_jump_table *sfmt_open_jump_table(const char *path, int mexp);
+void sfmt_close_jump_table(sfmt_jump_table *table);
+const jump_poly *sfmt_jump_table_poly(const sfmt_jump_table *table, int k);
+int sfmt_jump_substream(w128_t *intstate, const sfmt_jump_table *table,
+			int k, uint64_t i);
+int sfmt_init_gen_rand_substream(w128_t *intstate,
+				 const sfmt_jump_table *table, int stride,
+				 uint64_t count, uint64_t i, uint32_t seed);
+int sfmt_init_by_array_substream(w128_t *intstate,
+				 const sfmt_jump_table *table, int stride,
+				 uint64_t count, uint64_t i,
+				 uint32_t *init_key, int key_length);
+int sfmt_split(const w128_t *parent, w128_t *child,
+	       const sfmt_jump_table *table, int level);
+int sfmt_split_path(w128_t *intstate, const sfmt_jump_table *table,
+		    int level, uint64_t path, int depth);
+int sfmt_discard(sfmt_t *sfmt, const sfmt_jump_table *table, uint64_t n);
+
+/*------------------------------------------------------
+  checkpoint indexes of libsfmt-extstate.a
+  ------------------------------------------------------*/
+/**
+ * a stream index: the state tables before the blocks 0, 2^k, 2 * 2^k,
+ * ... of a stream, in memory by sfmt_new_index() or mapped from a file
+ * of sfmt_save_index()
+ */
+struct SFMT_INDEX_T {
+    /** the parameter set */
+    const sfmt_params_t *params;
+    /** the checkpoints are 2^k blocks apart */
+    int k;
+    /** the number of the checkpoints */
+    uint64_t count;
+    /** the number of the blocks of the stream */
+    uint64_t blocks;
+    /** the mapped file, or NULL */
+    void *map;
+    /** size of the mapped file */
+    size_t size;
+    /** the checkpoints, count state tables */
+    const w128_t *states;
+};
+/** a stream index */
+typedef struct SFMT_INDEX_T sfmt_index;
+
+sfmt_index *sfmt_new_index(int mexp, const w128_t *origin, uint64_t blocks,
+			   size_t budget);
+int sfmt_save_index(const sfmt_index *index, const char *path);
+sfmt_index *sfmt_open_index(const char *path, int mexp);
+void sfmt_free_index(sfmt_index *index);
+int sfmt_index_block(const sfmt_index *index, const sfmt_jump_table *table,
+		     uint64_t b, w128_t *block);
+
+/*------------------------------------------------------
+  parallel fill of libsfmt-extstate.a
+  ------------------------------------------------------*/
+/** a thread pool filling arrays of a parameter set, opaque */
+typedef struct SFMT_POOL_T sfmt_pool;
+
+sfmt_pool *sfmt_new_pool(int mexp, int threads, int chunk);
+void sfmt_free_pool(sfmt_pool *pool);
+void sfmt_pool_gen_rand_array(sfmt_pool *pool, w128_t *array, int size,
+			      w128_t *intstate);
+void sfmt_pool_fill_array32(sfmt_pool *pool, sfmt_t *sfmt, uint32_t *array,
+			    int size);
+
+/*------------------------------------------------------
+  producer threads of libsfmt-extstate.a
+  ------------------------------------------------------*/
+/**
+ * the reader of a ring of blocks made by a producer thread; the members
+ * below are read by the inline functions, and the ring and the thread
+ * are opaque
+ */
+struct SFMT_RING_T {
+    /** the 32-bit integers of the block being read */
+    const uint32_t *block32;
+    /** index of the next unused 32-bit integer of block32 */
+    int idx;
+    /** size of the block being read in 32-bit integers */
+    int size32;
+    /** the ring and the producer thread */
+    struct SFMT_PRODUCER_T *producer;
+};
+/** the reader of a ring of blocks made by a producer thread */
+typedef struct SFMT_RING_T sfmt_ring;
+
+sfmt_ring *sfmt_new_ring(sfmt_t *sfmt, int count, int tables, int cpu);
+void sfmt_free_ring(sfmt_ring *ring, sfmt_t *sfmt);
+void sfmt_ring_next_block(sfmt_ring *ring);
+
+/**
+ * This function returns the next 32-bit output of the stream of a ring,
+ * the same as sfmt_next32() of the generator the ring was made from.
+ * @param ring the ring
+ * @return 32-bit pseudorandom number
+ */
+static inline uint32_t sfmt_ring_next32(sfmt_ring *ring) {
+    if (ring->idx >= ring->size32) {
+	sfmt_ring_next_block(ring);
+    }
+    return ring->block32[ring->idx++];
+}
+
+/**
+ * This function returns the next 64-bit output of the stream of a ring,
+ * the same as sfmt_next64() of the generator the ring was made from.
+ * @param ring the ring
+ * @return 64-bit pseudorandom number
+ */
+static inline uint64_t sfmt_ring_next64(sfmt_ring *ring) {
+    uint64_t r;
+    int i = ring->idx;
+
+    if (i + 2 <= ring->size32) {
+	r = ring->block32[i] | ((uint64_t)ring->block32[i + 1] << 32);
+	ring->idx = i + 2;
+	return r;
+    }
+    r = sfmt_ring_next32(ring);
+    return r | ((uint64_t)sfmt_ring_next32(ring) << 32);
+}
+
+/*------------------------------------------------------
+  incremental generators of libsfmt-extstate.a
+  ------------------------------------------------------*/
+/** a helper thread making the next state tables of generators, opaque */
+typedef struct SFMT_HELPER_T sfmt_helper;
+
+/**
+ * a generator which makes its next state table a slice at a time while
+ * the current one is read, instead of all at once at the end of it, or
+ * after a watermark by a helper thread or by the caller when idle
+ */
+struct SFMT_INC_T {
+    /** the state table being read, aligned to 64 bytes */
+    w128_t *state;
+    /** the 32-bit integer pointer to state */
+    uint32_t *state32;
+    /** the next state table, made up to the 128-bit integer made */
+    w128_t *next;
+    /** index of the next unused 32-bit integer of state32 */
+    int idx;
+    /** the index of state32 at which the next slice is made */
+    int mark;
+    /** the number of the 128-bit integers of next made */
+    int made;
+    /** the number of the 128-bit integers made by a refill */
+    int slice;
+    /** size of the internal state array in 32-bit integers */
+    int n32;
+    /** the parameter set */
+    const sfmt_params_t *params;
+    /** the index of state32 after which next is made, or -1 for slices */
+    int watermark;
+    /** the helper thread making next, or NULL */
+    sfmt_helper *helper;
+    /** the state of the request of next to the helper, accessed atomically */
+    int job;
+    /** the generators before and after this in the queue of the helper */
+    struct SFMT_INC_T *queue_prev, *queue_next;
+};
+/** an incremental generator */
+typedef struct SFMT_INC_T sfmt_inc_t;
+
+sfmt_inc_t *sfmt_new_inc(const sfmt_t *sfmt, int slice);
+void sfmt_free_inc(sfmt_inc_t *inc);
+void sfmt_inc_refill(sfmt_inc_t *inc);
+int sfmt_inc_set_watermark(sfmt_inc_t *inc, int watermark,
+			   sfmt_helper *helper);
+int sfmt_inc_idle(sfmt_inc_t *inc, int size);
+sfmt_helper *sfmt_new_helper(int cpu);
+void sfmt_free_helper(sfmt_helper *helper);
+
+/**
+ * This function returns the next 32-bit output of an incremental
+ * generator, the same as sfmt_next32() of the generator it was made
+ * from.
+ * @param inc the incremental generator
+ * @return 32-bit pseudorandom number
+ */
+static inline uint32_t sfmt_inc_next32(sfmt_inc_t *inc) {
+    if (inc->idx >= inc->mark) {
+	sfmt_inc_refill(inc);
+    }
+    return inc->state32[inc->idx++];
+}
+
+/**
+ * This function returns the next 64-bit output of an incremental
+ * generator, the same as sfmt_next64() of the generator it was made
+ * from.
+ * @param inc the incremental generator
+ * @return 64-bit pseudorandom number
+ */
+static inline uint64_t sfmt_inc_next64(sfmt_inc_t *inc) {
+    uint64_t r;
+    int i = inc->idx;
+
+    if (i + 2 <= inc->mark) {
+	r = inc->state32[i] | ((uint64_t)inc->state32[i + 1] << 32);
+	inc->idx = i + 2;
+	return r;
+    }
+    r = sfmt_inc_next32(inc);
+    return r | ((uint64_t)sfmt_inc_next32(inc) << 32);
+}
+
+/*------------------------------------------------------
+  shared generators of libsfmt-extstate.a
+  ------------------------------------------------------*/
+/** a generator shared by threads which claim ranges of its output, opaque */
+typedef struct SFMT_SHARED_T sfmt_shared;
+
+sfmt_shared *sfmt_new_shared(sfmt_t *sfmt, int count, int tables);
+void sfmt_free_shared(sfmt_shared *shared, sfmt_t *sfmt);
+uint64_t sfmt_shared_fill_array32(sfmt_shared *shared, uint32_t *array,
+				  int size);
+
+/*------------------------------------------------------
+  per-thread generators of libsfmt-extstate.a
+  ------------------------------------------------------*/
+/** a set of per-thread generators of disjoint substreams, opaque */
+typedef struct SFMT_LOCAL_T sfmt_local;
+
+sfmt_local *sfmt_new_local(const sfmt_jump_table *table, int stride,
+			   uint64_t count, uint32_t seed);
+void sfmt_free_local(sfmt_local *local);
+sfmt_t *sfmt_local_get(sfmt_local *local);
+
+#if defined(__cplusplus)
+}
+#endif
+
 #endif /* SFMT_EXTSTATE_H */
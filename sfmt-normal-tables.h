@@ -0,0 +1,435 @@
+/* This file is a part of sfmt-extstate */
+
+/**
+ * @file  sfmt-normal-tables.h
+ * @brief tables of the 256-layer ziggurat of sfmt-extstate-normal.c
+ *
+ * @author Kenji Rikitake
+ *
+ * Copyright (C) 2010 Kenji Rikitake. All rights reserved.
+ *
+ * The new BSD License is applied to this software, see LICENSE.txt
+ *
+ * @note Generated offline in double precision.  With
+ * f(x) = exp(-x^2 / 2), the 256 layers have the common area
+ * V = R f(R) + the integral of f from R to infinity, where R is
+ * chosen so that the top layer reaches f = 1.  The right edges are
+ * x[0] = V / f(R) (the base layer with the tail), x[1] = R,
+ * x[i + 1] = f^{-1}(f(x[i]) + V / x[i]) and x[256] = 0.  The tables
+ * must not be regenerated with another precision, or the sequences of
+ * normal deviates will change.
+ */
+
+#ifndef SFMT_NORMAL_TABLES_H
+#define SFMT_NORMAL_TABLES_H
+
+/** the right edge of the base layer, where the tail begins */
+#define ZIG_R 3.6541528853610088
+
+/** the right edge of the layers divided by 2^52 */
+static const double zig_w[256] = {
+    8.683627060801317e-16, 8.1138493376564842e-16, 7.6589363708055718e-16,
+    7.3724243017987969e-16, 7.1599949348306622e-16, 6.989718336387618e-16,
+    6.8468034175642568e-16, 6.7231504625055847e-16, 6.6138278850976622e-16,
+    6.5156033173449916e-16, 6.4262396595480544e-16, 6.344122407127504e-16,
+    6.2680469633012824e-16, 6.1970898945816246e-16, 6.1305272087252796e-16,
+    6.0677804093334475e-16, 6.0083796962719073e-16, 5.9519381496414432e-16,
+    5.8981331764778984e-16, 5.846692893455478e-16, 5.7973859457245927e-16,
+    5.7500137689198943e-16, 5.7044046212913871e-16, 5.6604089200824202e-16,
+    5.6178955535554137e-16, 5.5767489329265735e-16, 5.536866612467873e-16,
+    5.4981573508928111e-16, 5.4605395190747775e-16, 5.4239397822017094e-16,
+    5.3882920013340502e-16, 5.3535363118164939e-16, 5.3196183453383974e-16,
+    5.2864885695049422e-16, 5.2541017241775954e-16, 5.2224163380002333e-16,
+    5.1913943117576976e-16, 5.1610005577432273e-16, 5.1312026863067827e-16,
+    5.1019707323415609e-16, 5.0732769157335411e-16, 5.0450954308187275e-16,
+    5.0174022607180895e-16, 4.9901750130918215e-16, 4.9633927744039863e-16,
+    4.9370359802403336e-16, 4.9110862995952686e-16, 4.8855265313536024e-16,
+    4.860340511450811e-16, 4.8355130294115242e-16, 4.8110297531474162e-16,
+    4.7868771610487219e-16, 4.7630424805331364e-16, 4.7395136323258662e-16,
+    4.7162791798383503e-16, 4.6933282830933269e-16, 4.6706506567126286e-16,
+    4.6482365315432044e-16, 4.6260766195478427e-16, 4.6041620816311499e-16,
+    4.5824844981095637e-16, 4.5610358415674191e-16, 4.5398084518700311e-16,
+    4.5187950131300558e-16, 4.4979885324455467e-16, 4.4773823202475309e-16,
+    4.4569699721120401e-16, 4.4367453519065643e-16, 4.4167025761542005e-16,
+    4.3968359995105184e-16, 4.3771402012585845e-16, 4.357609972736846e-16,
+    4.3382403056227878e-16, 4.319026381002626e-16, 4.2999635591638289e-16,
+    4.2810473700531127e-16, 4.2622735043477942e-16, 4.2436378050930735e-16,
+    4.2251362598620444e-16, 4.2067649933990102e-16, 4.1885202607101069e-16,
+    4.1703984405683105e-16, 4.1523960294026829e-16, 4.1345096355442311e-16,
+    4.1167359738030213e-16, 4.0990718603532625e-16, 4.0815142079049348e-16,
+    4.0640600211422469e-16, 4.046706392410747e-16, 4.029450497636325e-16,
+    4.0122895924606261e-16, 3.9952210085785616e-16, 3.9782421502646791e-16,
+    3.961350491076132e-16, 3.9445435707208742e-16, 3.9278189920805391e-16,
+    3.911174418378203e-16, 3.8946075704819237e-16, 3.8781162243355847e-16,
+    3.8616982085091473e-16, 3.8453514018609576e-16, 3.8290737313052417e-16,
+    3.8128631696783764e-16, 3.7967177336979433e-16, 3.7806354820089589e-16,
+    3.7646145133120272e-16, 3.7486529645684872e-16, 3.7327490092779425e-16,
+    3.716900855823822e-16, 3.7011067458828979e-16, 3.6853649528949135e-16,
+    3.6696737805887009e-16, 3.65403156156137e-16, 3.6384366559073444e-16,
+    3.6228874498941915e-16, 3.6073823546823514e-16, 3.5919198050860299e-16,
+    3.5764982583726505e-16, 3.5611161930983884e-16, 3.5457721079774357e-16,
+    3.5304645207827401e-16, 3.5151919672760744e-16, 3.499953000165381e-16,
+    3.4847461880874137e-16, 3.4695701146137835e-16, 3.454423377278584e-16,
+    3.4393045866258313e-16, 3.4242123652750182e-16, 3.409145347003126e-16,
+    3.3941021758414891e-16, 3.3790815051859498e-16, 3.3640819969187651e-16,
+    3.3491023205407785e-16, 3.3341411523123725e-16, 3.3191971744017523e-16,
+    3.3042690740391284e-16, 3.2893555426753697e-16, 3.2744552751437067e-16,
+    3.2595669688230784e-16, 3.2446893228016978e-16, 3.2298210370394156e-16,
+    3.214960811527447e-16, 3.2001073454440114e-16, 3.1852593363044065e-16,
+    3.1704154791040285e-16, 3.1555744654528006e-16, 3.1407349826994462e-16,
+    3.1258957130439984e-16, 3.1110553326368925e-16, 3.096212510662922e-16,
+    3.0813659084082967e-16, 3.066514178308954e-16, 3.0516559629782182e-16,
+    3.0367898942118009e-16, 3.0219145919680605e-16, 3.0070286633213296e-16,
+    2.9921307013860116e-16, 2.9772192842090274e-16, 2.9622929736280645e-16,
+    2.9473503140929329e-16, 2.9323898314471802e-16, 2.9174100316669436e-16,
+    2.9024093995538404e-16, 2.8873863973784799e-16, 2.872339463470978e-16,
+    2.8572670107545995e-16, 2.8421674252184046e-16, 2.8270390643244778e-16,
+    2.8118802553450193e-16, 2.7966892936242286e-16, 2.7814644407595426e-16,
+    2.7662039226963888e-16, 2.7509059277301657e-16, 2.7355686044086781e-16,
+    2.7201900593277311e-16, 2.7047683548119942e-16, 2.6893015064726149e-16,
+    2.6737874806323623e-16, 2.6582241916083058e-16, 2.6426094988411885e-16,
+    2.6269412038597242e-16, 2.6112170470670179e-16, 2.5954347043351692e-16,
+    2.5795917833928662e-16, 2.5636858199893959e-16, 2.5477142738169437e-16,
+    2.5316745241713578e-16, 2.5155638653296574e-16, 2.4993795016204519e-16,
+    2.4831185421610862e-16, 2.4667779952327035e-16, 2.4503547622614934e-16,
+    2.4338456313711009e-16, 2.4172472704675001e-16, 2.4005562198135038e-16,
+    2.3837688840454219e-16, 2.3668815235791579e-16, 2.3498902453470935e-16,
+    2.3327909928004336e-16, 2.3155795351040784e-16, 2.2982514554424669e-16,
+    2.2808021383450161e-16, 2.2632267559285669e-16, 2.2455202529414345e-16,
+    2.2276773304789544e-16, 2.209692428223531e-16, 2.1915597050427261e-16,
+    2.1732730177564358e-16, 2.1548258978581448e-16, 2.1362115259449858e-16,
+    2.1174227035760334e-16, 2.0984518222370342e-16, 2.0792908290414007e-16,
+    2.0599311887403696e-16, 2.04036384154802e-16, 2.0205791562071642e-16,
+    2.0005668776273318e-16, 1.9803160683128162e-16, 1.9598150426628815e-16,
+    1.9390512930625096e-16, 1.9180114064838612e-16, 1.8966809700774752e-16,
+    1.8750444639373874e-16, 1.8530851388618009e-16, 1.8307848764826743e-16,
+    1.8081240285799142e-16, 1.785081231697672e-16, 1.7616331923000989e-16,
+    1.7377544365864849e-16, 1.7134170176559646e-16, 1.6885901708676584e-16,
+    1.6632399058420823e-16, 1.6373285203969843e-16, 1.6108140175274921e-16,
+    1.5836494009290876e-16, 1.5557818169460754e-16, 1.5271515003596186e-16,
+    1.4976904668391022e-16, 1.4673208742364402e-16, 1.4359529452056923e-16,
+    1.4034823001242357e-16, 1.3697864842571174e-16, 1.3347203736824093e-16,
+    1.2981099886264002e-16, 1.2597439914637061e-16, 1.2193617278714331e-16,
+    1.1766359457022889e-16, 1.1311470196108999e-16, 1.0823430288447645e-16,
+    1.0294750314240972e-16, 9.7148600765677125e-17, 9.0680604050594231e-17,
+    8.3293668157930295e-17, 7.45487048124761e-17, 6.3543524174051452e-17,
+    4.7793301757275489e-17
+};
+
+/** 2^52 times the ratio of the right edges of the next and the layer */
+static const double zig_k[256] = {
+    4208095142473572.0, 4251099761679434.0, 4335125104963628.0,
+    4373832704204283.0, 4396496531309975.0, 4411517007702131.0,
+    4422264825074740.0, 4430368316897338.0, 4436714892174061.0,
+    4441831266659619.0, 4446050695647665.0, 4449594783440798.0,
+    4452616884242348.0, 4455226650325009.0, 4457504658253067.0,
+    4459511507635971.0, 4461293691124341.0, 4462887501169282.0,
+    4464321701199635.0, 4465619395558397.0, 4466799366045354.0,
+    4467877045039529.0, 4468865235838895.0, 4469774653883156.0,
+    4470614338917719.0, 4471391972746493.0, 4472114126959003.0,
+    4472786458058295.0, 4473413862618200.0, 4474000601739904.0,
+    4474550401693506.0, 4475066535915646.0, 4475551892286424.0,
+    4476009028690434.0, 4476440219183782.0, 4476847492576191.0,
+    4477232664848704.0, 4477597366530538.0, 4477943065929958.0,
+    4478271088936406.0, 4478582635972393.0, 4478878796564387.0,
+    4479160561915450.0, 4479428835793398.0, 4479684443993061.0,
+    4479928142586662.0, 4480160625140311.0, 4480382529045225.0,
+    4480594441088331.0, 4480796902367134.0, 4480990412637506.0,
+    4481175434169564.0, 4481352395175569.0, 4481521692864464.0,
+    4481683696169780.0, 4481838748191073.0, 4481987168383485.0,
+    4482129254525304.0, 4482265284489409.0, 4482395517841076.0,
+    4482520197281720.0, 4482639549955636.0, 4482753788634691.0,
+    4482863112794071.0, 4482967709590562.0, 4483067754753535.0,
+    4483163413397547.0, 4483254840764470.0, 4483342182902157.0,
+    4483425577285833.0, 4483505153387764.0, 4483581033200083.0,
+    4483653331715197.0, 4483722157367660.0, 4483787612441035.0,
+    4483849793442887.0, 4483908791450713.0, 4483964692431364.0,
+    4484017577536215.0, 4484067523374159.0, 4484114602264271.0,
+    4484158882469814.0, 4484200428415113.0, 4484239300886655.0,
+    4484275557219678.0, 4484309251471359.0, 4484340434581640.0,
+    4484369154522621.0, 4484395456437369.0, 4484419382768917.0,
+    4484440973380153.0, 4484460265665251.0, 4484477294653230.0,
+    4484492093104165.0, 4484504691598554.0, 4484515118620291.0,
+    4484523400633636.0, 4484529562154580.0, 4484533625816926.0,
+    4484535612433423.0, 4484535541052220.0, 4484533429008906.0,
+    4484529291974393.0, 4484523143998832.0, 4484514997551787.0,
+    4484504863558830.0, 4484492751434740.0, 4484478669113435.0,
+    4484462623074795.0, 4484444618368474.0, 4484424658634833.0,
+    4484402746123075.0, 4484378881706674.0, 4484353064896185.0,
+    4484325293849473.0, 4484295565379450.0, 4484263874959345.0,
+    4484230216725549.0, 4484194583478081.0, 4484156966678662.0,
+    4484117356446451.0, 4484075741551420.0, 4484032109405371.0,
+    4483986446050596.0, 4483938736146144.0, 4483888962951686.0,
+    4483837108308932.0, 4483783152620564.0, 4483727074826623.0,
+    4483668852378323.0, 4483608461209170.0, 4483545875703378.0,
+    4483481068661427.0, 4483414011262724.0, 4483344673025224.0,
+    4483273021761922.0, 4483199023534056.0, 4483122642600925.0,
+    4483043841366126.0, 4482962580320076.0, 4482878817978627.0,
+    4482792510817576.0, 4482703613202871.0, 4482612077316275.0,
+    4482517853076245.0, 4482420888053758.0, 4482321127382800.0,
+    4482218513665204.0, 4482112986869492.0, 4482004484223382.0,
+    4481892940099539.0, 4481778285894164.0, 4481660449897960.0,
+    4481539357158973.0, 4481414929336783.0, 4481287084547452.0,
+    4481155737198611.0, 4481020797814009.0, 4480882172846772.0,
+    4480739764480587.0, 4480593470417938.0, 4480443183654460.0,
+    4480288792238367.0, 4480130179013871.0, 4479967221347353.0,
+    4479799790834989.0, 4479627752990372.0, 4479450966910587.0,
+    4479269284918997.0, 4479082552182885.0, 4478890606303905.0,
+    4478693276879083.0, 4478490385029917.0, 4478281742896886.0,
+    4478067153096380.0, 4477846408136804.0, 4477619289790266.0,
+    4477385568415884.0, 4477145002230339.0, 4476897336520865.0,
+    4476642302795321.0, 4476379617863426.0, 4476108982842610.0,
+    4475830082081194.0, 4475542581990776.0, 4475246129778808.0,
+    4474940352071305.0, 4474624853414417.0, 4474299214642294.0,
+    4473962991097124.0, 4473615710685531.0, 4473256871753524.0,
+    4472885940759934.0, 4472502349725738.0, 4472105493433674.0,
+    4471694726349190.0, 4471269359229842.0, 4470828655385769.0,
+    4470371826548633.0, 4469898028300364.0, 4469406355006041.0,
+    4468895834186994.0, 4468365420260671.0, 4467813987562542.0,
+    4467240322552143.0, 4466643115089763.0, 4466020948651920.0,
+    4465372289331869.0, 4464695473445501.0, 4463988693531857.0,
+    4463249982500383.0, 4462477195632267.0, 4461667990089170.0,
+    4460819801517195.0, 4459929817254120.0, 4458994945550385.0,
+    4458011780094444.0, 4456976558985043.0, 4455885117109369.0,
+    4454732830656798.0, 4453514552210512.0, 4452224534496485.0,
+    4450856340408624.0, 4449402736340121.0, 4447855565093316.0,
+    4446205593658138.0, 4444442329865861.0, 4442553800234660.0,
+    4440526279077423.0, 4438343955930065.0, 4435988524278344.0,
+    4433438668975191.0, 4430669422005230.0, 4427651345409292.0,
+    4424349484777079.0, 4420722014516421.0, 4416718463613198.0,
+    4412277362218203.0, 4407323076021239.0, 4401761481783921.0,
+    4395473957549319.0, 4388308869042394.0, 4380069246215645.0,
+    4370494503737297.0, 4359232558744729.0, 4345795907393187.0,
+    4329489775174549.0, 4309289223136600.0, 4283617341590291.0,
+    4249917568205991.0, 4203757248105139.0, 4136731738896246.0,
+    4030768804392669.0, 3838760076542248.0, 3387314423973473.0,
+    0.0
+};
+
+/** the density exp(-x^2 / 2) at the right edges, and 1 at the top */
+static const double zig_f[257] = {
+    0.0004774677646093862, 0.001260285930498598, 0.002609072746102164,
+    0.0040379725933630374, 0.0055224032992510106, 0.0070508754713732415,
+    0.0086165827693987489, 0.010214971439701487, 0.01184275785790791,
+    0.01349745060173989, 0.015177088307935337, 0.016880083152543187,
+    0.018605121275724671, 0.020351096230044538, 0.022117062707308899,
+    0.02390220330579591, 0.025705804008548945, 0.027527235669603148,
+    0.029365939758133387, 0.031221417191920328, 0.03309321945857862,
+    0.034980941461716174, 0.036884215688567402, 0.038802707404526238,
+    0.040736110655941085, 0.042684144916474612, 0.044646552251294602,
+    0.046623094901930527, 0.048613553215868695, 0.050617723860947941,
+    0.052635418276792377, 0.054666461324889094, 0.056710690106203082,
+    0.058767952920933925, 0.060838108349540017, 0.062921024437758225,
+    0.065016577971242953, 0.067124653827788566, 0.069245144397006825,
+    0.071377949058890472, 0.073522973713981379, 0.075680130358927178,
+    0.077849336702096122, 0.080030515814663153, 0.082223595813202988,
+    0.084428509570353541, 0.086645194450558141, 0.088873592068275969,
+    0.091113648066373829, 0.093365311912691096, 0.095628536713009082,
+    0.09790327903886259, 0.1001894987688101, 0.10248715894193534,
+    0.10479622562248721, 0.107116667774684, 0.10944845714681205,
+    0.11179156816383844, 0.11414597782783878, 0.11651166562561123,
+    0.11888861344291038, 0.12127680548479063, 0.1236762282015969,
+    0.12608687022018628, 0.1285087222799999, 0.13094177717364472,
+    0.13338602969166952, 0.13584147657125412, 0.13830811644855109,
+    0.14078594981444506, 0.14327497897351382, 0.14577520800599442,
+    0.14828664273257494, 0.15080929068184615, 0.1533431610602633,
+    0.15588826472447975, 0.15844461415592484, 0.16101222343751165,
+    0.16359110823236628, 0.16618128576448263, 0.16878277480121209,
+    0.1713955956375065, 0.17401977008183936, 0.17665532144373555,
+    0.17930227452284822, 0.18196065559952312, 0.18463049242679985,
+    0.1873118142238008, 0.19000465167046546, 0.19270903690358965,
+    0.1954250035141348, 0.19815258654577567, 0.20089182249465717,
+    0.20364274931033544, 0.20640540639788124, 0.20917983462112549,
+    0.2119660763070306, 0.214764175251174, 0.21757417672433152,
+    0.22039612748015233, 0.22323007576391782, 0.22607607132238053,
+    0.22893416541468053, 0.23180441082433889, 0.23468686187233026,
+    0.23758157443123834, 0.24048860594050084, 0.24340801542275048,
+    0.24633986350126399, 0.24928421241852858, 0.25224112605594223,
+    0.25521066995466196, 0.25819291133761924, 0.26118791913272121,
+    0.26419576399726119, 0.26721651834356147, 0.27025025636587546,
+    0.27329705406857707, 0.27635698929566832, 0.27943014176163794,
+    0.28251659308370758, 0.28561642681550176, 0.28872972848218292,
+    0.29185658561709521, 0.29499708779996181, 0.29815132669668548,
+    0.30131939610080305, 0.30450139197664999, 0.30769741250429206,
+    0.31090755812628651, 0.31413193159633718, 0.31737063802991361,
+    0.32062378495690536, 0.32389148237639109, 0.3271738428136014,
+    0.33047098137916359, 0.33378301583071845, 0.33711006663700605,
+    0.34045225704452187, 0.34380971314685072, 0.34718256395679364,
+    0.35057094148140611, 0.35397498080007678, 0.3573948201457805,
+    0.36083060098964803, 0.36428246812900406, 0.36775056977903259,
+    0.37123505766823955, 0.37473608713789125, 0.37825381724561929,
+    0.38178841087339377, 0.38534003484007745, 0.38890886001878894,
+    0.39249506145931584, 0.39609881851583273, 0.39972031498019756,
+    0.40335973922111484, 0.40701728432947376, 0.41069314827018866,
+    0.41438753404089163, 0.41810064983784861, 0.42183270922949634,
+    0.42558393133802241, 0.42935454102944193, 0.43314476911265276,
+    0.43695485254798599, 0.44078503466580438, 0.44463556539573978,
+    0.4485067015072034, 0.45239870686184896, 0.45631185267871677,
+    0.4602464178128432, 0.46420268904817463, 0.46818096140569387,
+    0.47218153846773042, 0.47620473271950614, 0.48025086590904703,
+    0.4843202694266836, 0.48841328470545831, 0.49253026364386882,
+    0.4966715690524901, 0.50083757512614913, 0.50502866794346846,
+    0.50924524599574816, 0.51348772074732718, 0.51775651722975646,
+    0.52205207467232195, 0.52637484717168459, 0.53072530440366228,
+    0.53510393238045795, 0.53951123425695258, 0.54394773119002671,
+    0.54841396325526637, 0.55291049042583296, 0.55743789361876661,
+    0.56199677581452512, 0.566587763256165, 0.57121150673525378,
+    0.57586868297235427, 0.58055999610079145, 0.58528617926337179,
+    0.59004799633282623, 0.59484624376798767, 0.5996817526191256,
+    0.604555390697468, 0.60946806492577366, 0.61442072388891411,
+    0.61941436060583455, 0.62445001554702673, 0.62952877992483691,
+    0.63465179928762383, 0.63982027745305681, 0.64503548082082263,
+    0.65029874311081703, 0.6556114705796976, 0.66097514777666344,
+    0.66639134390875043, 0.67186171989708243, 0.67738803621877375,
+    0.68297216164499508, 0.68861608300467203, 0.69432191612611693,
+    0.70009191813651184, 0.70592850133275453, 0.71183424887824864,
+    0.71781193263072218, 0.72386453346863044, 0.72999526456147645,
+    0.73620759812686298, 0.74250529634015139, 0.74889244721915715,
+    0.75537350650709645, 0.7619533468367955, 0.76863731579848649,
+    0.7754313049811874, 0.78234183265480273, 0.78937614356602492,
+    0.7965423304229593, 0.80384948317096472, 0.81130787431265672,
+    0.81892919160370292, 0.82672683394622204, 0.8347162929868841,
+    0.84291565311220484, 0.85134625845867862, 0.8600336211963322,
+    0.86900868803685771, 0.87830965580891807, 0.88798466075583415,
+    0.89809592189834431, 0.90872644005213177, 0.91999150503934801,
+    0.93206007595923157, 0.94519895344230087, 0.95987909180010811,
+    0.97710170126767337, 1
+};
+
+/** the right edge of the layers divided by 2^23 */
+static const float zig_wf[256] = {
+    4.66198685e-07f, 4.35608968e-07f, 4.11186022e-07f, 3.95804022e-07f,
+    3.843993e-07f, 3.75257656e-07f, 3.6758496e-07f, 3.60946387e-07f,
+    3.55077191e-07f, 3.49803798e-07f, 3.45006129e-07f, 3.40597467e-07f,
+    3.3651321e-07f, 3.32703735e-07f, 3.2913016e-07f, 3.25761476e-07f,
+    3.22572419e-07f, 3.19542238e-07f, 3.16653626e-07f, 3.13891945e-07f,
+    3.11244776e-07f, 3.08701516e-07f, 3.062529e-07f, 3.03890886e-07f,
+    3.0160848e-07f, 2.99399431e-07f, 2.97258254e-07f, 2.95180087e-07f,
+    2.93160497e-07f, 2.91195562e-07f, 2.89281729e-07f, 2.87415787e-07f,
+    2.85594837e-07f, 2.83816206e-07f, 2.82077451e-07f, 2.80376355e-07f,
+    2.78710871e-07f, 2.77079096e-07f, 2.75479351e-07f, 2.73909961e-07f,
+    2.72369476e-07f, 2.70856503e-07f, 2.69369735e-07f, 2.67907978e-07f,
+    2.66470124e-07f, 2.65055093e-07f, 2.63661946e-07f, 2.62289717e-07f,
+    2.60937554e-07f, 2.59604633e-07f, 2.58290186e-07f, 2.56993502e-07f,
+    2.557139e-07f, 2.54450697e-07f, 2.53203297e-07f, 2.5197113e-07f,
+    2.50753658e-07f, 2.49550311e-07f, 2.48360607e-07f, 2.47184062e-07f,
+    2.4602025e-07f, 2.44868744e-07f, 2.43729119e-07f, 2.42600947e-07f,
+    2.41483917e-07f, 2.40377631e-07f, 2.39281746e-07f, 2.38195952e-07f,
+    2.3711992e-07f, 2.36053339e-07f, 2.34995923e-07f, 2.33947404e-07f,
+    2.32907496e-07f, 2.31875958e-07f, 2.30852535e-07f, 2.29836985e-07f,
+    2.28829066e-07f, 2.27828565e-07f, 2.26835269e-07f, 2.25848979e-07f,
+    2.24869467e-07f, 2.23896564e-07f, 2.22930069e-07f, 2.21969799e-07f,
+    2.21015583e-07f, 2.2006725e-07f, 2.1912463e-07f, 2.18187566e-07f,
+    2.17255902e-07f, 2.16329482e-07f, 2.15408164e-07f, 2.14491791e-07f,
+    2.1358025e-07f, 2.12673385e-07f, 2.11771066e-07f, 2.10873182e-07f,
+    2.09979575e-07f, 2.09090146e-07f, 2.08204781e-07f, 2.07323339e-07f,
+    2.06445733e-07f, 2.05571837e-07f, 2.04701536e-07f, 2.0383473e-07f,
+    2.02971322e-07f, 2.0211121e-07f, 2.01254267e-07f, 2.00400436e-07f,
+    1.99549589e-07f, 1.98701656e-07f, 1.97856522e-07f, 1.97014117e-07f,
+    1.96174327e-07f, 1.9533708e-07f, 1.94502292e-07f, 1.93669862e-07f,
+    1.92839721e-07f, 1.92011782e-07f, 1.91185975e-07f, 1.90362186e-07f,
+    1.89540373e-07f, 1.88720435e-07f, 1.87902302e-07f, 1.87085888e-07f,
+    1.86271123e-07f, 1.85457949e-07f, 1.84646254e-07f, 1.83836008e-07f,
+    1.83027097e-07f, 1.82219466e-07f, 1.81413057e-07f, 1.80607771e-07f,
+    1.79803564e-07f, 1.79000338e-07f, 1.78198036e-07f, 1.77396601e-07f,
+    1.76595933e-07f, 1.75795975e-07f, 1.74996671e-07f, 1.74197936e-07f,
+    1.73399698e-07f, 1.72601901e-07f, 1.71804459e-07f, 1.71007315e-07f,
+    1.70210384e-07f, 1.6941361e-07f, 1.68616921e-07f, 1.67820247e-07f,
+    1.67023515e-07f, 1.66226641e-07f, 1.65429569e-07f, 1.64632226e-07f,
+    1.63834528e-07f, 1.63036418e-07f, 1.62237811e-07f, 1.61438621e-07f,
+    1.60638791e-07f, 1.59838237e-07f, 1.59036887e-07f, 1.5823467e-07f,
+    1.57431487e-07f, 1.56627252e-07f, 1.55821922e-07f, 1.55015371e-07f,
+    1.54207555e-07f, 1.53398361e-07f, 1.52587702e-07f, 1.51775509e-07f,
+    1.50961668e-07f, 1.50146107e-07f, 1.49328741e-07f, 1.48509443e-07f,
+    1.47688141e-07f, 1.46864721e-07f, 1.46039085e-07f, 1.45211146e-07f,
+    1.44380778e-07f, 1.43547879e-07f, 1.42712324e-07f, 1.41874011e-07f,
+    1.41032828e-07f, 1.40188646e-07f, 1.39341338e-07f, 1.38490776e-07f,
+    1.37636832e-07f, 1.36779363e-07f, 1.35918242e-07f, 1.35053313e-07f,
+    1.34184418e-07f, 1.33311417e-07f, 1.32434138e-07f, 1.31552426e-07f,
+    1.30666095e-07f, 1.29774975e-07f, 1.28878881e-07f, 1.27977614e-07f,
+    1.2707099e-07f, 1.26158767e-07f, 1.2524076e-07f, 1.24316728e-07f,
+    1.23386442e-07f, 1.22449634e-07f, 1.21506062e-07f, 1.20555455e-07f,
+    1.19597516e-07f, 1.18631959e-07f, 1.17658466e-07f, 1.16676709e-07f,
+    1.15686333e-07f, 1.14686983e-07f, 1.13678269e-07f, 1.12659777e-07f,
+    1.11631074e-07f, 1.10591714e-07f, 1.09541197e-07f, 1.08479014e-07f,
+    1.07404617e-07f, 1.06317408e-07f, 1.0521677e-07f, 1.04102021e-07f,
+    1.0297245e-07f, 1.01827283e-07f, 1.0066568e-07f, 9.94867477e-08f,
+    9.82895116e-08f, 9.70729204e-08f, 9.58358157e-08f, 9.45769614e-08f,
+    9.32949789e-08f, 9.1988376e-08f, 9.06554973e-08f, 8.92945096e-08f,
+    8.7903409e-08f, 8.64799219e-08f, 8.50215329e-08f, 8.35253999e-08f,
+    8.19883184e-08f, 8.04066431e-08f, 7.87761891e-08f, 7.70921389e-08f,
+    7.53488791e-08f, 7.35398515e-08f, 7.16572544e-08f, 6.9691751e-08f,
+    6.76319871e-08f, 6.54639862e-08f, 6.31701624e-08f, 6.07279915e-08f,
+    5.81078474e-08f, 5.52695205e-08f, 5.21562562e-08f, 4.8683777e-08f,
+    4.47179467e-08f, 4.0023032e-08f, 3.41146702e-08f, 2.56588333e-08f
+};
+
+/** 2^23 times the ratio of the right edges of the next and the layer */
+static const float zig_kf[256] = {
+    7838188.0f, 7918290.0f, 8074799.0f, 8146898.0f,
+    8189112.0f, 8217090.0f, 8237110.0f, 8252204.0f,
+    8264025.0f, 8273555.0f, 8281414.0f, 8288016.0f,
+    8293645.0f, 8298506.0f, 8302749.0f, 8306487.0f,
+    8309807.0f, 8312775.0f, 8315447.0f, 8317864.0f,
+    8320062.0f, 8322069.0f, 8323910.0f, 8325604.0f,
+    8327168.0f, 8328616.0f, 8329961.0f, 8331213.0f,
+    8332382.0f, 8333475.0f, 8334499.0f, 8335460.0f,
+    8336365.0f, 8337216.0f, 8338019.0f, 8338778.0f,
+    8339495.0f, 8340175.0f, 8340818.0f, 8341429.0f,
+    8342010.0f, 8342561.0f, 8343086.0f, 8343586.0f,
+    8344062.0f, 8344516.0f, 8344949.0f, 8345362.0f,
+    8345757.0f, 8346134.0f, 8346495.0f, 8346839.0f,
+    8347169.0f, 8347484.0f, 8347786.0f, 8348075.0f,
+    8348351.0f, 8348616.0f, 8348869.0f, 8349112.0f,
+    8349344.0f, 8349566.0f, 8349779.0f, 8349983.0f,
+    8350178.0f, 8350364.0f, 8350542.0f, 8350712.0f,
+    8350875.0f, 8351030.0f, 8351179.0f, 8351320.0f,
+    8351455.0f, 8351583.0f, 8351705.0f, 8351821.0f,
+    8351930.0f, 8352035.0f, 8352133.0f, 8352226.0f,
+    8352314.0f, 8352396.0f, 8352474.0f, 8352546.0f,
+    8352614.0f, 8352676.0f, 8352734.0f, 8352788.0f,
+    8352837.0f, 8352882.0f, 8352922.0f, 8352958.0f,
+    8352989.0f, 8353017.0f, 8353040.0f, 8353060.0f,
+    8353075.0f, 8353087.0f, 8353094.0f, 8353098.0f,
+    8353098.0f, 8353094.0f, 8353086.0f, 8353075.0f,
+    8353060.0f, 8353041.0f, 8353018.0f, 8352992.0f,
+    8352962.0f, 8352929.0f, 8352891.0f, 8352851.0f,
+    8352806.0f, 8352758.0f, 8352706.0f, 8352651.0f,
+    8352592.0f, 8352529.0f, 8352463.0f, 8352393.0f,
+    8352319.0f, 8352241.0f, 8352160.0f, 8352075.0f,
+    8351986.0f, 8351894.0f, 8351797.0f, 8351696.0f,
+    8351592.0f, 8351484.0f, 8351371.0f, 8351254.0f,
+    8351134.0f, 8351009.0f, 8350880.0f, 8350746.0f,
+    8350608.0f, 8350466.0f, 8350319.0f, 8350168.0f,
+    8350012.0f, 8349851.0f, 8349686.0f, 8349515.0f,
+    8349340.0f, 8349159.0f, 8348973.0f, 8348782.0f,
+    8348586.0f, 8348383.0f, 8348176.0f, 8347962.0f,
+    8347743.0f, 8347517.0f, 8347285.0f, 8347047.0f,
+    8346802.0f, 8346551.0f, 8346293.0f, 8346028.0f,
+    8345755.0f, 8345475.0f, 8345188.0f, 8344892.0f,
+    8344589.0f, 8344277.0f, 8343956.0f, 8343627.0f,
+    8343289.0f, 8342941.0f, 8342583.0f, 8342216.0f,
+    8341838.0f, 8341449.0f, 8341050.0f, 8340638.0f,
+    8340215.0f, 8339780.0f, 8339332.0f, 8338871.0f,
+    8338396.0f, 8337906.0f, 8337402.0f, 8336883.0f,
+    8336347.0f, 8335795.0f, 8335225.0f, 8334638.0f,
+    8334031.0f, 8333405.0f, 8332758.0f, 8332090.0f,
+    8331399.0f, 8330684.0f, 8329945.0f, 8329180.0f,
+    8328388.0f, 8327567.0f, 8326716.0f, 8325833.0f,
+    8324918.0f, 8323967.0f, 8322979.0f, 8321952.0f,
+    8320883.0f, 8319771.0f, 8318612.0f, 8317404.0f,
+    8316143.0f, 8314826.0f, 8313450.0f, 8312011.0f,
+    8310504.0f, 8308924.0f, 8307266.0f, 8305525.0f,
+    8303694.0f, 8301765.0f, 8299732.0f, 8297586.0f,
+    8295317.0f, 8292914.0f, 8290365.0f, 8287658.0f,
+    8284776.0f, 8281703.0f, 8278418.0f, 8274901.0f,
+    8271124.0f, 8267059.0f, 8262672.0f, 8257923.0f,
+    8252764.0f, 8247143.0f, 8240993.0f, 8234236.0f,
+    8226779.0f, 8218507.0f, 8209278.0f, 8198919.0f,
+    8187208.0f, 8173862.0f, 8158514.0f, 8140680.0f,
+    8119703.0f, 8094675.0f, 8064303.0f, 8026676.0f,
+    7978859.0f, 7916088.0f, 7830108.0f, 7705263.0f,
+    7507891.0f, 7150247.0f, 6309364.0f, 0.0f
+};
+
+#endif /* SFMT_NORMAL_TABLES_H */
@@ -0,0 +1,63 @@
+/* This file is a part of sfmt-extstate */
+
+/** 
+ * @file sfmt-params-M11213.h
+ *
+ * @brief SFMT configuration file for a parameter set of
+ * period ((2^11213)-1)
+ *
+ * @author Mutsuo Saito (Hiroshima University)
+ * @author Makoto Matsumoto (Hiroshima University)
+ * @author Kenji Rikitake
+ *
+ * Copyright (C) 2006, 2007 Mutsuo Saito, Makoto Matsumoto and Hiroshima
+ * University. All rights reserved.
+ *
+ * Copyright (C) 2010 Kenji Rikitake. All rights reserved.
+ *
+ * The new BSD License is applied to this software.
+ * see LICENSE.txt
+ *
+ * @note Other sets of parameters are available from SFMT-1.3.3
+ * source code.
+ */
+
+#ifndef SFMT_PARAMS_M11213_H
+#define SFMT_PARAMS_M11213_H
+
+/** Mersenne Exponent. The period of the sequence 
+ *  is a multiple of 2^MEXP-1. */
+#define MEXP 11213
+/** SFMT generator has an internal state array of 128-bit integers,
+ * and N is its size. */
+#define N ((MEXP / 128) + 1)
+/** N32 is the size of internal state array when regarded as an array
+ * of 32-bit integers.*/
+#define N32 (N * 4)
+/** the pick up position of the array. */
+#define POS1 68
+/** the parameter of shift left as four 32-bit registers. */
+#define SL1 14
+/** the parameter of shift left as one 128-bit register. 
+ * The 128-bit integer is shifted by (SL2 * 8) bits. */
+#define SL2 3
+/** the parameter of shift right as four 32-bit registers. */
+#define SR1 7
+/** the parameter of shift right as one 128-bit register. 
+ * The 128-bit integer is shifted by (SL2 * 8) bits. */
+#define SR2 3
+/** A bitmask, used in the recursion.  These parameters are introduced
+ * to break symmetry of SIMD. */
+#define MSK1 0xeffff7fbU
+#define MSK2 0xffffffefU
+#define MSK3 0xdfdfbfffU
+#define MSK4 0x7fffdbfdU
+/** These definitions are part of a 128-bit period certification vector. */
+#define PARITY1	0x00000001U
+#define PARITY2	0x00000000U
+#define PARITY3	0xe8148000U
+#define PARITY4	0xd0c7afa3U
+/* identification string for the algorithm */
+#define IDSTR	"SFMT-11213:68-14-3-7-3:effff7fb-ffffffef-dfdfbfff-7fffdbfd"
+
+#endif /* SFMT_PARAMS_M11213_H */
@@ -0,0 +1,54 @@
+/* This file is a part of sfmt-extstate */
+
+/**
+ * @file sfmt-params.h
+ *
+ * @brief SFMT configuration file selecting a parameter set by MEXP
+ *
+ * @author Mutsuo Saito (Hiroshima University)
+ * @author Makoto Matsumoto (Hiroshima University)
+ * @author Kenji Rikitake
+ *
+ * Copyright (C) 2006, 2007 Mutsuo Saito, Makoto Matsumoto and Hiroshima
+ * University. All rights reserved.
+ *
+ * Copyright (C) 2010 Kenji Rikitake. All rights reserved.
+ *
+ * The new BSD License is applied to this software.
+ * see LICENSE.txt
+ *
+ * @note Only the files which are compiled for one Mersenne exponent
+ * include this file; define MEXP (e.g. -DMEXP=607) to choose the
+ * parameter set, which is 19937 by default.  sfmt-extstate.h does not
+ * include this file, so the macros N, N32, POS1, SL1, ... do not leak
+ * into the programs using the parameter set descriptors.
+ */
+
+#ifndef SFMT_PARAMS_H
+#define SFMT_PARAMS_H
+
+#if !defined(MEXP) || MEXP == 19937
+  #include "sfmt-params-M19937.h"
+#elif MEXP == 607
+  #include "sfmt-params-M607.h"
+#elif MEXP == 1279
+  #include "sfmt-params-M1279.h"
+#elif MEXP == 2281
+  #include "sfmt-params-M2281.h"
+#elif MEXP == 4253
+  #include "sfmt-params-M4253.h"
+#elif MEXP == 11213
+  #include "sfmt-params-M11213.h"
+#elif MEXP == 44497
+  #include "sfmt-params-M44497.h"
+#elif MEXP == 86243
+  #include "sfmt-params-M86243.h"
+#elif MEXP == 132049
+  #include "sfmt-params-M132049.h"
+#elif MEXP == 216091
+  #include "sfmt-params-M216091.h"
+#else
+  #error "MEXP is not valid."
+#endif
+
+#endif /* SFMT_PARAMS_H */
@@ -21,6 +21,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <assert.h>
+#include "sfmt-params.h"
 #include "sfmt-extstate.h"
 
 uint32_t gen_rand32(void);
@@ -0,0 +1,493 @@
+/* This file is a part of sfmt-extstate */
+/**
+ * @file  sfmtjumpcalc.c
+ * @brief jump polynomial calculator program of sfmt-extstate.
+ *
+ * @author Kenji Rikitake
+ *
+ * Copyright (C) 2010 Kenji Rikitake. All rights reserved.
+ *
+ * The new BSD License is applied to this software, see LICENSE.txt
+ *
+ * @note This program calculates the characteristic polynomial m(x) of
+ * a parameter set, of the library or of a row of a csv file of
+ * Original-SFMT-1.3.3/params, by sfmt_min_poly(), and the jump
+ * polynomials x^J mod m(x) by square-and-multiply.  A square in
+ * GF(2)[x] only spreads the bits; the reduction modulo m(x) is the
+ * Barrett reduction, two multiplications by the precomputed
+ * floor(x^(2d) / m(x)) and m(x), by the Karatsuba method over
+ * carry-less 64-bit multiplications, PCLMULQDQ with HAVE_PCLMUL.  A
+ * jump table of 216091 takes seconds instead of minutes of
+ * sfmt_write_jump_table().
+ *
+ * The polynomials are printed in hexadecimal, the coefficients of
+ * x^0, ..., x^3 in the first digit (of values 1, 2, 4, 8), those of
+ * x^4, ..., x^7 in the second, and so on.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include "sfmt-extstate.h"
+#if defined(HAVE_PCLMUL)
+#include <wmmintrin.h>
+#endif
+
+/** the size in 64-bit integers below which the schoolbook method is used */
+#define KARATSUBA_MIN 16
+
+/** a modulus and its constants of the Barrett reduction */
+struct MODULUS_T {
+    /** the modulus m */
+    uint64_t *m;
+    /** floor(x^(2d) / m) */
+    uint64_t *mu;
+    /** degree of m */
+    int d;
+    /** size of m and mu in 64-bit integers */
+    int words;
+    /** work area */
+    uint64_t *work;
+};
+/** a modulus and its constants of the Barrett reduction */
+typedef struct MODULUS_T modulus_t;
+
+void clmul(uint64_t *r, uint64_t a, uint64_t b);
+void mul_school(uint64_t *r, const uint64_t *a, const uint64_t *b, int n);
+void mul_karatsuba(uint64_t *r, const uint64_t *a, const uint64_t *b, int n,
+		   uint64_t *tmp);
+void shift_right(uint64_t *r, const uint64_t *a, int words, int shift);
+void init_modulus(modulus_t *mod, const uint64_t *m, int d);
+void sqr_mod(uint64_t *r, const modulus_t *mod, int e);
+int parse_csv(sfmt_params_t *params, char *idstr, const char *path,
+	      int line);
+int parse_step(uint32_t *step, int size, const char *str);
+void print_poly(const uint64_t *poly, int degree);
+void usage(const char *name);
+
+/**
+ * This function multiplies two 64-bit polynomials.
+ * @param r the product, 2 64-bit integers
+ * @param a a polynomial
+ * @param b a polynomial
+ */
+void clmul(uint64_t *r, uint64_t a, uint64_t b) {
+#if defined(HAVE_PCLMUL)
+    __m128i p = _mm_clmulepi64_si128(_mm_cvtsi64_si128(a),
+				     _mm_cvtsi64_si128(b), 0);
+
+    r[0] = _mm_cvtsi128_si64(p);
+    r[1] = _mm_cvtsi128_si64(_mm_unpackhi_epi64(p, p));
+#else
+    int i;
+    uint64_t lo = 0;
+    uint64_t hi = 0;
+
+    for (i = 0; i < 64; i++) {
+	if ((b >> i) & 1) {
+	    lo ^= a << i;
+	    hi ^= i == 0 ? 0 : a >> (64 - i);
+	}
+    }
+    r[0] = lo;
+    r[1] = hi;
+#endif
+}
+
+/**
+ * This function multiplies two polynomials by the schoolbook method.
+ * @param r the product, 2n 64-bit integers
+ * @param a a polynomial, n 64-bit integers
+ * @param b a polynomial, n 64-bit integers
+ * @param n size of a and b
+ */
+void mul_school(uint64_t *r, const uint64_t *a, const uint64_t *b, int n) {
+    int i, j;
+    uint64_t p[2];
+
+    memset(r, 0, sizeof(uint64_t) * n * 2);
+    for (i = 0; i < n; i++) {
+	for (j = 0; j < n; j++) {
+	    clmul(p, a[i], b[j]);
+	    r[i + j] ^= p[0];
+	    r[i + j + 1] ^= p[1];
+	}
+    }
+}
+
+/**
+ * This function multiplies two polynomials by the Karatsuba method.
+ * @param r the product, 2n 64-bit integers
+ * @param a a polynomial, n 64-bit integers
+ * @param b a polynomial, n 64-bit integers
+ * @param n size of a and b
+ * @param tmp work area, 8n 64-bit integers
+ */
+void mul_karatsuba(uint64_t *r, const uint64_t *a, const uint64_t *b, int n,
+		   uint64_t *tmp) {
+    int i;
+    int l = (n + 1) / 2;
+    int h = n - l;
+    uint64_t *sa = tmp;
+    uint64_t *sb = sa + l;
+    uint64_t *mid = sb + l;
+
+    if (n < KARATSUBA_MIN) {
+	mul_school(r, a, b, n);
+	return;
+    }
+    /* a = a0 + a1 X, b = b0 + b1 X, X = x^(64l) */
+    mul_karatsuba(r, a, b, l, mid + 2 * l);
+    memset(r + 2 * l, 0, sizeof(uint64_t) * (2 * n - 2 * l));
+    mul_karatsuba(r + 2 * l, a + l, b + l, h, mid + 2 * l);
+    memcpy(sa, a, sizeof(uint64_t) * l);
+    memcpy(sb, b, sizeof(uint64_t) * l);
+    for (i = 0; i < h; i++) {
+	sa[i] ^= a[l + i];
+	sb[i] ^= b[l + i];
+    }
+    /* (a0 + a1)(b0 + b1) - a0 b0 - a1 b1 */
+    mul_karatsuba(mid, sa, sb, l, mid + 2 * l);
+    for (i = 0; i < 2 * l; i++) {
+	mid[i] ^= r[i];
+    }
+    for (i = 0; i < 2 * h; i++) {
+	mid[i] ^= r[2 * l + i];
+    }
+    for (i = 0; i < 2 * l; i++) {
+	r[l + i] ^= mid[i];
+    }
+}
+
+/**
+ * This function divides a polynomial by x^shift.
+ * @param r the quotient, words 64-bit integers
+ * @param a the polynomial, at least words + shift / 64 + 1 64-bit
+ * integers
+ * @param words size of r
+ * @param shift the power of x
+ */
+void shift_right(uint64_t *r, const uint64_t *a, int words, int shift) {
+    int i;
+    int w = shift / 64;
+    int b = shift % 64;
+
+    for (i = 0; i < words; i++) {
+	r[i] = b == 0 ? a[w + i]
+	    : (a[w + i] >> b) | (a[w + i + 1] << (64 - b));
+    }
+}
+
+/**
+ * This function calculates the constants of the Barrett reduction
+ * modulo m, floor(x^(2d) / m) by the long division.
+ * @param mod the modulus to be initialized
+ * @param m the modulus, of degree d
+ * @param d the degree of m, at least 1
+ */
+void init_modulus(modulus_t *mod, const uint64_t *m, int d) {
+    int i, j;
+    int words = d / 64 + 1;
+    uint64_t *rem;
+
+    mod->d = d;
+    mod->words = words;
+    mod->m = calloc(words, sizeof(uint64_t));
+    mod->mu = calloc(words, sizeof(uint64_t));
+    mod->work = malloc(sizeof(uint64_t) * words * 16);
+    rem = calloc(words * 2 + 1, sizeof(uint64_t));
+    if (mod->m == NULL || mod->mu == NULL || mod->work == NULL
+	|| rem == NULL) {
+	fprintf(stderr, "no memory\n");
+	exit(1);
+    }
+    memcpy(mod->m, m, sizeof(uint64_t) * words);
+    /* x^(2d) = mu m + rem */
+    rem[2 * d / 64] = (uint64_t)1 << (2 * d % 64);
+    for (i = 2 * d; i >= d; i--) {
+	if ((rem[i / 64] >> (i % 64)) & 1) {
+	    mod->mu[(i - d) / 64] |= (uint64_t)1 << ((i - d) % 64);
+	    for (j = 0; j < words; j++) {
+		int s = i - d;
+
+		rem[j + s / 64] ^= m[j] << (s % 64);
+		if (s % 64 != 0) {
+		    rem[j + s / 64 + 1] ^= m[j] >> (64 - s % 64);
+		}
+	    }
+	}
+    }
+    free(rem);
+}
+
+/**
+ * This function calculates r^2 x^e modulo a polynomial.
+ * @param r the polynomial, less than the modulus in degree,
+ * 2 * mod->words 64-bit integers
+ * @param mod the modulus
+ * @param e 0 or 1
+ */
+void sqr_mod(uint64_t *r, const modulus_t *mod, int e) {
+    int j, k;
+    int words = mod->words;
+    int d = mod->d;
+    uint64_t v;
+    uint64_t *q = mod->work;
+    uint64_t *p = q + words;
+    uint64_t *tmp = p + words * 2;
+
+    /* r = r^2: the bit j goes to the bit 2j */
+    for (j = words - 1; j >= 0; j--) {
+	for (k = 1; k >= 0; k--) {
+	    v = (uint32_t)(r[j] >> (32 * k));
+	    v = (v | (v << 16)) & 0x0000ffff0000ffffULL;
+	    v = (v | (v << 8)) & 0x00ff00ff00ff00ffULL;
+	    v = (v | (v << 4)) & 0x0f0f0f0f0f0f0f0fULL;
+	    v = (v | (v << 2)) & 0x3333333333333333ULL;
+	    v = (v | (v << 1)) & 0x5555555555555555ULL;
+	    r[2 * j + k] = v;
+	}
+    }
+    /* r = r * x */
+    if (e) {
+	for (j = words * 2 - 1; j > 0; j--) {
+	    r[j] = (r[j] << 1) | (r[j - 1] >> 63);
+	}
+	r[0] <<= 1;
+    }
+    /* r = r - floor(floor(r / x^d) mu / x^d) m */
+    shift_right(q, r, words, d);
+    mul_karatsuba(p, q, mod->mu, words, tmp);
+    shift_right(q, p, words, d);
+    mul_karatsuba(p, q, mod->m, words, tmp);
+    for (j = 0; j < words * 2; j++) {
+	r[j] ^= p[j];
+    }
+}
+
+/**
+ * This function reads a parameter set from a row of a csv file of
+ * Original-SFMT-1.3.3/params.
+ * @param params the parameter set, without the functions
+ * @param idstr the identification string, 128 characters
+ * @param path the csv file name
+ * @param line the row, 1 to 32
+ * @return 0, or -1 if the row is not found
+ */
+int parse_csv(sfmt_params_t *params, char *idstr, const char *path,
+	      int line) {
+    int i;
+    char buf[1024];
+    char mexp[16], dd[16], pos1[16], sl1[16], sl2[16], sr1[16], sr2[16];
+    char msk[4][16], parity[4][16];
+    FILE *fp = fopen(path, "r");
+
+    if (fp == NULL) {
+	return -1;
+    }
+    for (i = 0; i <= line; i++) {
+	if (fgets(buf, sizeof(buf), fp) == NULL) {
+	    fclose(fp);
+	    return -1;
+	}
+    }
+    fclose(fp);
+    if (line < 1
+	|| sscanf(buf, "%15[^,],%15[^,],%15[^,],%15[^,],%15[^,],%15[^,],"
+		  "%15[^,],%15[^,],%15[^,],%15[^,],%15[^,],%15[^,],"
+		  "%15[^,],%15[^,],%15[^,],", mexp, dd, pos1, sl1, sl2,
+		  sr1, sr2, msk[0], msk[1], msk[2], msk[3], parity[0],
+		  parity[1], parity[2], parity[3]) != 15) {
+	return -1;
+    }
+    memset(params, 0, sizeof(*params));
+    params->mexp = atoi(mexp);
+    params->n = params->mexp / 128 + 1;
+    params->n32 = params->n * 4;
+    params->pos1 = atoi(pos1);
+    params->sl1 = atoi(sl1);
+    params->sl2 = atoi(sl2);
+    params->sr1 = atoi(sr1);
+    params->sr2 = atoi(sr2);
+    for (i = 0; i < 4; i++) {
+	params->msk[i] = (uint32_t)strtoul(msk[i], NULL, 16);
+	params->parity[i] = (uint32_t)strtoul(parity[i], NULL, 16);
+    }
+    /* as csv2param.awk */
+    sprintf(idstr, "SFMT-%s:%s-%s-%s-%s-%s:%s-%s-%s-%s", mexp, pos1, sl1,
+	    sl2, sr1, sr2, msk[0], msk[1], msk[2], msk[3]);
+    params->idstr = idstr;
+    return params->mexp > 0 ? 0 : -1;
+}
+
+/**
+ * This function reads a step count, in decimal or as 2^k.
+ * @param step the step count, an array of 32-bit integers, the lowest
+ * first
+ * @param size size of step
+ * @param str the string
+ * @return the length of step used, or -1 if str is not a step count or
+ * too large
+ */
+int parse_step(uint32_t *step, int size, const char *str) {
+    int i, k;
+    uint64_t carry;
+
+    memset(step, 0, sizeof(uint32_t) * size);
+    if (strncmp(str, "2^", 2) == 0) {
+	k = atoi(str + 2);
+	if (k < 0 || k >= size * 32) {
+	    return -1;
+	}
+	step[k / 32] = (uint32_t)1 << (k % 32);
+	return k / 32 + 1;
+    }
+    if (*str == '\0') {
+	return -1;
+    }
+    for (; *str != '\0'; str++) {
+	if (*str < '0' || *str > '9') {
+	    return -1;
+	}
+	carry = *str - '0';
+	for (i = 0; i < size; i++) {
+	    carry += (uint64_t)step[i] * 10;
+	    step[i] = (uint32_t)carry;
+	    carry >>= 32;
+	}
+	if (carry != 0) {
+	    return -1;
+	}
+    }
+    return size;
+}
+
+/**
+ * This function prints a polynomial in hexadecimal.
+ * @param poly the polynomial
+ * @param degree the degree of poly
+ */
+void print_poly(const uint64_t *poly, int degree) {
+    int i;
+
+    for (i = 0; i <= degree; i += 4) {
+	putchar("0123456789abcdef"[(poly[i / 64] >> (i % 64)) & 15]);
+    }
+    putchar('\n');
+}
+
+void usage(const char *name) {
+    fprintf(stderr, "usage:\n");
+    fprintf(stderr, "%s [-m mexp | -c csv-file line-no] -p\n", name);
+    fprintf(stderr, "%s [-m mexp | -c csv-file line-no] -s step\n", name);
+    fprintf(stderr, "%s [-m mexp | -c csv-file line-no]"
+	    " -t kmin kmax file\n", name);
+    fprintf(stderr, "-p prints the characteristic polynomial\n");
+    fprintf(stderr, "-s prints the jump polynomial of step (decimal or 2^k)"
+	    " 128-bit integers\n");
+    fprintf(stderr, "-t writes the jump table of 2^kmin, ..., 2^kmax 128-bit"
+	    " integers\n");
+}
+
+int main(int argc, char *argv[]) {
+    int i, d, k;
+    int kmin, kmax;
+    int step_length;
+    int words;
+    uint32_t step[64];
+    char idstr[128];
+    uint64_t *m, *r, *coef;
+    sfmt_params_t params;
+    const sfmt_params_t *lib;
+    modulus_t mod;
+
+    if (argc >= 3 && strcmp(argv[1], "-m") == 0) {
+	lib = sfmt_get_params(atoi(argv[2]));
+	if (lib == NULL) {
+	    fprintf(stderr, "%s: unknown mexp %s\n", argv[0], argv[2]);
+	    return 1;
+	}
+	params = *lib;
+	i = 3;
+    } else if (argc >= 4 && strcmp(argv[1], "-c") == 0) {
+	if (parse_csv(&params, idstr, argv[2], atoi(argv[3])) != 0) {
+	    fprintf(stderr, "%s: no line %s in %s\n", argv[0], argv[3],
+		    argv[2]);
+	    return 1;
+	}
+	i = 4;
+    } else {
+	usage(argv[0]);
+	return 1;
+    }
+    if (!(argc == i + 1 && strcmp(argv[i], "-p") == 0)
+	&& !(argc == i + 2 && strcmp(argv[i], "-s") == 0)
+	&& !(argc == i + 4 && strcmp(argv[i], "-t") == 0)) {
+	usage(argv[0]);
+	return 1;
+    }
+
+    words = params.n * 2 + 1;
+    m = calloc(words, sizeof(uint64_t));
+    r = calloc(words * 2, sizeof(uint64_t));
+    if (m == NULL || r == NULL) {
+	fprintf(stderr, "no memory\n");
+	return 1;
+    }
+    d = sfmt_min_poly(&params, m);
+    if (d == -1) {
+	fprintf(stderr, "no memory\n");
+	return 1;
+    }
+    if (d != params.n * 128) {
+	fprintf(stderr, "%s: no characteristic polynomial of degree %d"
+		" found\n", argv[0], params.n * 128);
+	return 1;
+    }
+    if (strcmp(argv[i], "-p") == 0) {
+	print_poly(m, d);
+	return 0;
+    }
+    init_modulus(&mod, m, d);
+    if (strcmp(argv[i], "-s") == 0) {
+	step_length = parse_step(step, 64, argv[i + 1]);
+	if (step_length < 0) {
+	    fprintf(stderr, "%s: bad step %s\n", argv[0], argv[i + 1]);
+	    return 1;
+	}
+	r[0] = 1;
+	for (k = step_length * 32 - 1; k >= 0; k--) {
+	    sqr_mod(r, &mod, (step[k / 32] >> (k % 32)) & 1);
+	}
+	for (k = d - 1; k > 0 && ((r[k / 64] >> (k % 64)) & 1) == 0; k--) {
+	}
+	print_poly(r, k);
+	return 0;
+    }
+    kmin = atoi(argv[i + 1]);
+    kmax = atoi(argv[i + 2]);
+    if (kmin < 0 || kmax < kmin) {
+	usage(argv[0]);
+	return 1;
+    }
+    coef = malloc(sizeof(uint64_t) * params.n * 2 * (kmax - kmin + 1));
+    if (coef == NULL) {
+	fprintf(stderr, "no memory\n");
+	return 1;
+    }
+    /* x^(2^k) = (x^(2^(k - 1)))^2 */
+    r[0] = 2;
+    for (k = 0; k <= kmax; k++) {
+	if (k >= kmin) {
+	    memcpy(coef + (size_t)params.n * 2 * (k - kmin), r,
+		   sizeof(uint64_t) * params.n * 2);
+	}
+	sqr_mod(r, &mod, 0);
+    }
+    if (sfmt_save_jump_table(argv[i + 3], &params, kmin, kmax - kmin + 1,
+			     coef) != 0) {
+	fprintf(stderr, "%s: cannot write %s\n", argv[0], argv[i + 3]);
+	return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,33 @@
+/* This file is a part of sfmt-extstate */
+/**
+ * @file  sfmtjumptab.c
+ * @brief jump table file writer program of sfmt-extstate.
+ *
+ * @author Kenji Rikitake
+ *
+ * Copyright (C) 2010 Kenji Rikitake. All rights reserved.
+ *
+ * The new BSD License is applied to this software, see LICENSE.txt
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "sfmt-extstate.h"
+
+int main(int argc, char *argv[]) {
+    int mexp, kmin, kmax;
+
+    if (argc != 5) {
+	fprintf(stderr, "usage:\n%s mexp kmin kmax file\n", argv[0]);
+	return 1;
+    }
+    mexp = atoi(argv[1]);
+    kmin = atoi(argv[2]);
+    kmax = atoi(argv[3]);
+    if (sfmt_write_jump_table(argv[4], mexp, kmin, kmax) != 0) {
+	fprintf(stderr, "%s: cannot write the jump table of %d to %s\n",
+		argv[0], mexp, argv[4]);
+	return 1;
+    }
+    return 0;
+}
@@ -21,16 +21,62 @@
 #include <stdlib.h>
 #include <string.h>
 #include <assert.h>
+#include <math.h>
+#include "sfmt-params.h"
 #include "sfmt-extstate.h"
+#if defined(SFMT_DISPATCH)
+#include <unistd.h>
+#include <pthread.h>
+#include "sfmt-normal-tables.h"
+#endif
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+  #include <x86intrin.h>
+  #define HAVE_RDTSC
+#endif
 
 #define BLOCK_SIZE 100000
 #define BLOCK_SIZE64 50000
 #define COUNT 1000
 
 uint32_t gen_rand32(void);
+uint64_t gen_rand64(void);
 void fill_array32(uint32_t *array, int size);
+void fill_array64(uint64_t *array, int size);
 void check32(void);
+void check32x(int m);
+void check64(void);
+void check_real(void);
+void check_reverse(void);
+void check_slice(void);
 void speed32(void);
+void speed64(void);
+#if defined(SFMT_DISPATCH)
+void check_params(void);
+void check_gen(void);
+void check_bounded(void);
+double ref_normal(const uint32_t *ref, int *pos);
+void check_normal(void);
+void check_lanes(void);
+void check_jump(void);
+void patch_file(const char *path, long offset, void *old, const void *new,
+		size_t size);
+void check_jump_table(void);
+void check_pool(void);
+void check_ring(void);
+void check_inc(void);
+void check_watermark(void);
+void *claim_shared(void *arg);
+void check_shared(void);
+void *use_local(void *arg);
+void check_local(void);
+void check_discard(void);
+void check_index(void);
+void speed_dispatch(void);
+void speed_bounded(void);
+void speed_normal(void);
+void speed_lanes(void);
+void speed_latency(void);
+#endif
 void paramdump(void);
 
 #if defined(HAVE_SSE2)
@@ -40,6 +86,9 @@ static __m128i array2[10000 / 4];
 static uint64_t array1[BLOCK_SIZE / 4][2];
 static uint64_t array2[10000 / 4][2];
 #endif
+/** arrays and state tables for the multi-stream functions */
+static w128_t xarray[4][10000 / 4];
+static w128_t xsfmt[4][N];
 
 /*--------------------------------------
   FILE GLOBAL VARIABLES
@@ -72,6 +121,26 @@ inline uint32_t gen_rand32(void) {
     return r;
 }
 
+/**
+ * This function generates and returns 64-bit pseudorandom number,
+ * made of the next two 32-bit pseudorandom numbers, the first one in
+ * the lower 32 bits, so that it can be mixed with gen_rand32().
+ * init_gen_rand or init_by_array must be called before this function.
+ * @return 64-bit pseudorandom number
+ */
+inline uint64_t gen_rand64(void) {
+    uint64_t r;
+
+    assert(initialized);
+    if (idx + 2 <= N32) {
+	r = psfmt32[idx] | ((uint64_t)psfmt32[idx + 1] << 32);
+	idx += 2;
+	return r;
+    }
+    r = gen_rand32();
+    return r | ((uint64_t)gen_rand32() << 32);
+}
+
 /**
  * This function generates pseudorandom 32-bit integers in the
  * specified array[] by one call. The number of pseudorandom integers
@@ -107,6 +176,32 @@ void fill_array32(uint32_t *array, int size) {
     idx = N32;
 }
 
+/**
+ * This function generates pseudorandom 64-bit integers in the
+ * specified array[] by one call, as fill_array32().  The conditions
+ * of fill_array32() apply, with size a multiple of 2 and greater than
+ * or equal to (MEXP / 128 + 1) * 2.
+ *
+ * @param array an array where pseudorandom 64-bit integers are filled
+ * by this function.
+ * @param size the number of 64-bit pseudorandom integers to be
+ * generated.
+ */
+void fill_array64(uint64_t *array, int size) {
+    assert(initialized);
+    assert(idx == N32);
+    assert(size % 2 == 0);
+    assert(size >= N * 2);
+
+    gen_rand_array((w128_t *)array, size / 2, &sfmt[0]);
+    idx = N32;
+#if defined(BIG_ENDIAN64)
+    for (size--; size >= 0; size--) {
+	array[size] = (array[size] << 32) | (array[size] >> 32);
+    }
+#endif
+}
+
 void check32(void) {
     int i;
     uint32_t *array32 = (uint32_t *)array1;
@@ -193,6 +288,275 @@ void check32(void) {
     }
 }
 
+/**
+ * This function checks the multi-stream functions against the
+ * single-stream functions, with a different seed for each stream.
+ * Nothing is printed unless a mismatch is found.
+ * @param m number of the streams, 2 or 4
+ */
+void check32x(int m) {
+    int i, j, k;
+    int sizes[3] = {N, N + POS1, 10000 / 4};
+    uint32_t *array32 = (uint32_t *)array1;
+    w128_t *xa[4] = {xarray[0], xarray[1], xarray[2], xarray[3]};
+    w128_t *xs[4] = {xsfmt[0], xsfmt[1], xsfmt[2], xsfmt[3]};
+
+    for (j = 0; j < m; j++) {
+	init_gen_rand(1234 + j, xs[j]);
+    }
+    if (m == 2) {
+	gen_rand_all_x2(xs);
+    } else {
+	gen_rand_all_x4(xs);
+    }
+    for (j = 0; j < m; j++) {
+	init_gen_rand(1234 + j, &sfmt[0]);
+	gen_rand_all(&sfmt[0]);
+	if (memcmp(xs[j], &sfmt[0], sizeof(sfmt)) != 0) {
+	    printf("\nmismatch at gen_rand_all_x%d stream %d\n", m, j);
+	    exit(1);
+	}
+    }
+    for (k = 0; k < 3; k++) {
+	for (j = 0; j < m; j++) {
+	    init_gen_rand(5678 + j, xs[j]);
+	}
+	if (m == 2) {
+	    gen_rand_array_x2(xa, sizes[k], xs);
+	    gen_rand_array_x2(xa, sizes[k], xs);
+	} else {
+	    gen_rand_array_x4(xa, sizes[k], xs);
+	    gen_rand_array_x4(xa, sizes[k], xs);
+	}
+	for (j = 0; j < m; j++) {
+	    init_gen_rand(5678 + j, &sfmt[0]);
+	    gen_rand_array((w128_t *)array32, sizes[k], &sfmt[0]);
+	    gen_rand_array((w128_t *)array32, sizes[k], &sfmt[0]);
+	    for (i = 0; i < sizes[k] * 4; i++) {
+		if (array32[i] != xarray[j][i / 4].u[i % 4]) {
+		    printf("\nmismatch at %d size %d gen_rand_array_x%d "
+			   "stream %d\n", i, sizes[k], m, j);
+		    exit(1);
+		}
+	    }
+	    if (memcmp(xs[j], &sfmt[0], sizeof(sfmt)) != 0) {
+		printf("\nmismatch at size %d gen_rand_array_x%d state %d\n",
+		       sizes[k], m, j);
+		exit(1);
+	    }
+	}
+    }
+}
+
+void check64(void) {
+    int i;
+    uint64_t *array64;
+    uint64_t *array64_2;
+    uint64_t r;
+    uint32_t ini[] = {5, 4, 3, 2, 1};
+
+    array64 = (uint64_t *)array1;
+    array64_2 = (uint64_t *)array2;
+    if (get_min_array_size64() > 5000) {
+	printf("array size too small!\n");
+	exit(1);
+    }
+    printf("%s\n64 bit generated randoms\n", get_idstring());
+    printf("init_gen_rand__________\n");
+    /* 64 bit generation */
+    {
+	init_gen_rand(4321, &sfmt[0]);
+	idx = N32;
+	initialized = 1;
+    }
+    fill_array64(array64, 5000);
+    fill_array64(array64_2, 5000);
+    {
+	init_gen_rand(4321, &sfmt[0]);
+	idx = N32;
+	initialized = 1;
+    }
+    for (i = 0; i < 5000; i++) {
+	if (i < 1000) {
+	    printf("%20"PRIu64" ", array64[i]);
+	    if (i % 3 == 2) {
+		printf("\n");
+	    }
+	}
+	r = gen_rand64();
+	if (r != array64[i]) {
+	    printf("\nmismatch at %d array64:%"PRIx64" gen:%"PRIx64"\n",
+		   i, array64[i], r);
+	    exit(1);
+	}
+    }
+    printf("\n");
+    for (i = 0; i < 700; i++) {
+	r = gen_rand64();
+	if (r != array64_2[i]) {
+	    printf("\nmismatch at %d array64_2:%"PRIx64" gen:%"PRIx64"\n",
+		   i, array64_2[i], r);
+	    exit(1);
+	}
+    }
+    printf("init_by_array__________\n");
+    /* 64 bit generation */
+    {
+	init_by_array(ini, 5, &sfmt[0]);
+	idx = N32;
+	initialized = 1;
+    }
+    fill_array64(array64, 5000);
+    fill_array64(array64_2, 5000);
+    {
+	init_by_array(ini, 5, &sfmt[0]);
+	idx = N32;
+	initialized = 1;
+    }
+    for (i = 0; i < 5000; i++) {
+	if (i < 1000) {
+	    printf("%20"PRIu64" ", array64[i]);
+	    if (i % 3 == 2) {
+		printf("\n");
+	    }
+	}
+	r = gen_rand64();
+	if (r != array64[i]) {
+	    printf("\nmismatch at %d array64:%"PRIx64" gen:%"PRIx64"\n",
+		   i, array64[i], r);
+	    exit(1);
+	}
+    }
+    printf("\n");
+    for (i = 0; i < 700; i++) {
+	r = gen_rand64();
+	if (r != array64_2[i]) {
+	    printf("\nmismatch at %d array64_2:%"PRIx64" gen:%"PRIx64"\n",
+		   i, array64_2[i], r);
+	    exit(1);
+	}
+    }
+    /* mixed with 32 bit generation, at an odd position */
+    {
+	init_by_array(ini, 5, &sfmt[0]);
+	idx = N32;
+	initialized = 1;
+    }
+    gen_rand32();
+    for (i = 0; i < 5000 - 1; i++) {
+	r = gen_rand64();
+	if (r != ((array64[i] >> 32) | (array64[i + 1] << 32))) {
+	    printf("\nmismatch at %d of odd gen_rand64:%"PRIx64"\n", i, r);
+	    exit(1);
+	}
+    }
+}
+
+/**
+ * This function checks gen_rand_all_double() and gen_rand_all_float()
+ * against gen_rand_all() and the conversion in standard C, so that all
+ * the backends give the same floating point numbers.  The arrays are
+ * not aligned on purpose.  Nothing is printed unless a mismatch is
+ * found.
+ */
+void check_real(void) {
+    int i, j;
+    double d;
+    float f;
+    double *array_d = (double *)array1 + 1;
+    float *array_f = (float *)array1 + 1;
+
+    init_gen_rand(1234, &sfmt[0]);
+    memcpy(xsfmt[0], sfmt, sizeof(sfmt));
+    for (i = 0; i < 3; i++) {
+	gen_rand_all(&sfmt[0]);
+	gen_rand_all_double(xsfmt[0], array_d);
+	if (memcmp(xsfmt[0], sfmt, sizeof(sfmt)) != 0) {
+	    printf("\nstate mismatch of gen_rand_all_double\n");
+	    exit(1);
+	}
+	for (j = 0; j < N * 2; j++) {
+	    d = (double)((((uint64_t)psfmt32[j * 2 + 1] << 32)
+			  | psfmt32[j * 2]) >> 12) * (1.0 / 4503599627370496.0);
+	    if (memcmp(&d, &array_d[j], sizeof(d)) != 0 || d >= 1.0) {
+		printf("\nmismatch at %d of gen_rand_all_double\n", j);
+		exit(1);
+	    }
+	}
+	gen_rand_all(&sfmt[0]);
+	gen_rand_all_float(xsfmt[0], array_f);
+	if (memcmp(xsfmt[0], sfmt, sizeof(sfmt)) != 0) {
+	    printf("\nstate mismatch of gen_rand_all_float\n");
+	    exit(1);
+	}
+	for (j = 0; j < N32; j++) {
+	    f = (float)(psfmt32[j] >> 9) * (1.0f / 8388608.0f);
+	    if (memcmp(&f, &array_f[j], sizeof(f)) != 0 || f >= 1.0f) {
+		printf("\nmismatch at %d of gen_rand_all_float\n", j);
+		exit(1);
+	    }
+	}
+    }
+}
+
+/**
+ * This function checks that gen_rand_all_reverse() undoes
+ * gen_rand_all(): the blocks after a seed are restored one by one, and
+ * the table before the seed, of no seed, is made by gen_rand_all()
+ * into the seed again.  Nothing is printed unless a mismatch is found.
+ */
+void check_reverse(void) {
+    int i;
+
+    init_gen_rand(1234, xsfmt[0]);
+    for (i = 1; i < 4; i++) {
+	memcpy(xsfmt[i], xsfmt[i - 1], sizeof(sfmt));
+	gen_rand_all(xsfmt[i]);
+    }
+    memcpy(sfmt, xsfmt[3], sizeof(sfmt));
+    for (i = 2; i >= 0; i--) {
+	gen_rand_all_reverse(&sfmt[0]);
+	if (memcmp(sfmt, xsfmt[i], sizeof(sfmt)) != 0) {
+	    printf("\nmismatch of gen_rand_all_reverse at block %d\n", i);
+	    exit(1);
+	}
+    }
+    gen_rand_all_reverse(&sfmt[0]);
+    gen_rand_all(&sfmt[0]);
+    if (memcmp(sfmt, xsfmt[0], sizeof(sfmt)) != 0) {
+	printf("\nmismatch of gen_rand_all_reverse before the seed\n");
+	exit(1);
+    }
+}
+
+/**
+ * This function checks that gen_rand_slice() makes the table of
+ * gen_rand_all() by slices of various sizes, and leaves the table it
+ * reads as it is.  Nothing is printed unless a mismatch is found.
+ */
+void check_slice(void) {
+    int i, j, k, size;
+    int sizes[] = {1, 2, 3, 5, 11};
+
+    init_gen_rand(1234, &sfmt[0]);
+    memcpy(xsfmt[0], sfmt, sizeof(sfmt));
+    memcpy(xsfmt[2], sfmt, sizeof(sfmt));
+    for (k = 0; k < 3; k++) {
+	for (i = 0, j = k; i < N; i += size, j++) {
+	    size = sizes[j % 5] < N - i ? sizes[j % 5] : N - i;
+	    gen_rand_slice(xsfmt[1], xsfmt[0], i, size);
+	}
+	gen_rand_all(&sfmt[0]);
+	if (memcmp(sfmt, xsfmt[1], sizeof(sfmt)) != 0
+	    || memcmp(xsfmt[0], xsfmt[2], sizeof(sfmt)) != 0) {
+	    printf("\nmismatch of gen_rand_slice at block %d\n", k);
+	    exit(1);
+	}
+	memcpy(xsfmt[0], sfmt, sizeof(sfmt));
+	memcpy(xsfmt[2], sfmt, sizeof(sfmt));
+    }
+}
+
 void speed32(void) {
     int i, j;
     clock_t clo;
@@ -241,55 +605,1761 @@ void speed32(void) {
     printf("32 bit SEQUE:%.0f", (double)min * 1000 / CLOCKS_PER_SEC);
     printf("ms for %u randoms generation\n",
 	   BLOCK_SIZE * COUNT);
-}
+    min = LONG_MAX;
+    {
+	w128_t *xs[2] = {xsfmt[0], xsfmt[1]};
 
-void paramdump(void) {
-    printf("MEXP = %d\n", MEXP);
-    printf("N = %d\n", N);
-    printf("N32 = %d\n", N32);
-    printf("POS1 = %d\n", POS1);
-    printf("SL1 = %d\n", SL1);
-    printf("SL2 = %d\n", SL2);
-    printf("SR1 = %d\n", SR1);
-    printf("SR2 = %d\n", SR2);
-    printf("MSK1 = %#010xU\n", MSK1);
-    printf("MSK2 = %#010xU\n", MSK2);
-    printf("MSK3 = %#010xU\n", MSK3);
-    printf("MSK4 = %#010xU\n", MSK4);
-    printf("PARITY1 = %#010xU\n", PARITY1);
-    printf("PARITY2 = %#010xU\n", PARITY2);
-    printf("PARITY3 = %#010xU\n", PARITY3);
-    printf("PARITY4 = %#010xU\n", PARITY4);
-    printf("IDSTR = %s\n", IDSTR);
-    printf("sizeof(sfmt) = %d\n", sizeof(sfmt));
+	init_gen_rand(1234, xs[0]);
+	init_gen_rand(5678, xs[1]);
+	for (i = 0; i < 10; i++) {
+	    clo = clock();
+	    for (j = 0; j < BLOCK_SIZE * COUNT / N32; j++) {
+		gen_rand_all_x2(xs);
+	    }
+	    clo = clock() - clo;
+	    if (clo < min) {
+		min = clo;
+	    }
+	}
+    }
+    printf("32 bit X2ALL:%.0f", (double)min * 1000 / CLOCKS_PER_SEC);
+    printf("ms for 2 x %u randoms generation\n",
+	   BLOCK_SIZE * COUNT / N32 * N32);
+    min = LONG_MAX;
+    {
+	w128_t *xs[4] = {xsfmt[0], xsfmt[1], xsfmt[2], xsfmt[3]};
+
+	for (i = 0; i < 4; i++) {
+	    init_gen_rand(1234 + i, xs[i]);
+	}
+	for (i = 0; i < 10; i++) {
+	    clo = clock();
+	    for (j = 0; j < BLOCK_SIZE * COUNT / N32; j++) {
+		gen_rand_all_x4(xs);
+	    }
+	    clo = clock() - clo;
+	    if (clo < min) {
+		min = clo;
+	    }
+	}
+    }
+    printf("32 bit X4ALL:%.0f", (double)min * 1000 / CLOCKS_PER_SEC);
+    printf("ms for 4 x %u randoms generation\n",
+	   BLOCK_SIZE * COUNT / N32 * N32);
 }
 
-int main(int argc, char *argv[]) {
-    int i;
-    int speed = 0;
-    int bit32 = 0;
-    int param = 0;
+void speed64(void) {
+    int i, j;
+    clock_t clo;
+    clock_t min = LONG_MAX;
+    uint64_t *array64 = (uint64_t *)array1;
 
-    for (i = 1; i < argc; i++) {
-	if (strncmp(argv[1],"-s", 2) == 0) {
-	    speed = 1;
+    if (get_min_array_size64() > BLOCK_SIZE64) {
+	printf("array size too small!\n");
+	exit(1);
+    }
+    /* 64 bit generation */
+    {
+	init_gen_rand(1234, &sfmt[0]);
+	idx = N32;
+	initialized = 1;
+    }
+    for (i = 0; i < 10; i++) {
+	clo = clock();
+	for (j = 0; j < COUNT; j++) {
+	    fill_array64(array64, BLOCK_SIZE64);
 	}
-	if (strncmp(argv[1],"-b32", 4) == 0) {
-	    bit32 = 1;
+	clo = clock() - clo;
+	if (clo < min) {
+	    min = clo;
 	}
-	if (strncmp(argv[1],"-p", 2) == 0) {
-	    param = 1;
+    }
+    printf("64 bit BLOCK:%.0f", (double)min * 1000/ CLOCKS_PER_SEC);
+    printf("ms for %u randoms generation\n",
+	   BLOCK_SIZE64 * COUNT);
+    min = LONG_MAX;
+    {
+	init_gen_rand(1234, &sfmt[0]);
+	idx = N32;
+	initialized = 1;
+    }
+    for (i = 0; i < 10; i++) {
+	clo = clock();
+	for (j = 0; j < BLOCK_SIZE64 * COUNT; j++) {
+	    gen_rand64();
+	}
+	clo = clock() - clo;
+	if (clo < min) {
+	    min = clo;
 	}
     }
-    if (speed + bit32 + param == 0) {
-	printf("usage:\n%s [-s | -b32 | -p]\n", argv[0]);
-	return 0;
+    printf("64 bit SEQUE:%.0f", (double)min * 1000 / CLOCKS_PER_SEC);
+    printf("ms for %u randoms generation\n",
+	   BLOCK_SIZE64 * COUNT);
+    min = LONG_MAX;
+    init_gen_rand(1234, &sfmt[0]);
+    for (i = 0; i < 10; i++) {
+	clo = clock();
+	for (j = 0; j < BLOCK_SIZE64 * COUNT / (N * 2); j++) {
+	    gen_rand_all_double(&sfmt[0], (double *)array1);
+	}
+	clo = clock() - clo;
+	if (clo < min) {
+	    min = clo;
+	}
     }
-    if (speed) {
-	speed32();
+    printf("DOUBLE   ALL:%.0f", (double)min * 1000 / CLOCKS_PER_SEC);
+    printf("ms for %u randoms generation\n",
+	   BLOCK_SIZE64 * COUNT / (N * 2) * (N * 2));
+}
+
+#if defined(SFMT_DISPATCH)
+/**
+ * This function checks the parameter set descriptor of MEXP against
+ * the parameters and the functions this file is compiled with.
+ * Nothing is printed unless a mismatch is found.
+ */
+void check_params(void) {
+    const sfmt_params_t *params = sfmt_get_params(MEXP);
+    uint32_t msk[4] = {MSK1, MSK2, MSK3, MSK4};
+    uint32_t parity[4] = {PARITY1, PARITY2, PARITY3, PARITY4};
+
+    if (params == NULL || sfmt_get_params(MEXP + 1) != NULL) {
+	printf("\nsfmt_get_params(%d) failed\n", MEXP);
+	exit(1);
     }
-    if (bit32) {
-	check32();
+    if (params->mexp != MEXP || params->n != N || params->n32 != N32
+	|| params->pos1 != POS1 || params->sl1 != SL1 || params->sl2 != SL2
+	|| params->sr1 != SR1 || params->sr2 != SR2
+	|| memcmp(params->msk, msk, sizeof(msk)) != 0
+	|| memcmp(params->parity, parity, sizeof(parity)) != 0
+	|| strcmp(params->idstr, IDSTR) != 0) {
+	printf("\nparameter mismatch of sfmt_params_M%d\n", MEXP);
+	exit(1);
+    }
+    params->init_gen_rand(4321, xsfmt[0]);
+    params->gen_rand_all(xsfmt[0]);
+    init_gen_rand(4321, &sfmt[0]);
+    gen_rand_all(&sfmt[0]);
+    if (memcmp(xsfmt[0], &sfmt[0], sizeof(sfmt)) != 0) {
+	printf("\nfunction mismatch of sfmt_params_M%d\n", MEXP);
+	exit(1);
+    }
+}
+
+/**
+ * This function checks sfmt_next32() and sfmt_fill_array32() of a
+ * generator, mixed with various sizes and alignments, against the
+ * sequence of gen_rand_array().  Nothing is printed unless a mismatch
+ * is found.
+ */
+void check_gen(void) {
+    int i, j, k;
+    int size;
+    uint32_t *ref = (uint32_t *)array1;
+    uint32_t *out = ref + BLOCK_SIZE / 2;
+    int sizes[] = {1, 3, N32 - 1, 4, N32 + 5, 2, 2 * N32, 7, N32};
+    sfmt_t *gen = sfmt_new(MEXP);
+
+    if (gen == NULL || sfmt_new(MEXP + 1) != NULL) {
+	printf("\nsfmt_new(%d) failed\n", MEXP);
+	exit(1);
+    }
+    init_gen_rand(4321, &sfmt[0]);
+    gen_rand_array((w128_t *)ref, BLOCK_SIZE / 8, &sfmt[0]);
+    sfmt_init_gen_rand(gen, 4321);
+    for (i = 0, k = 0; i + 2 * N32 + 2 < BLOCK_SIZE / 2; k++) {
+	/* 0 to 2 scalar draws, then a fill at an offset of 0 to 3 */
+	for (j = 0; j < k % 3; j++, i++) {
+	    if (sfmt_next32(gen) != ref[i]) {
+		printf("\nmismatch at %d of sfmt_next32\n", i);
+		exit(1);
+	    }
+	}
+	size = sizes[k % (sizeof(sizes) / sizeof(sizes[0]))];
+	sfmt_fill_array32(gen, out + k % 4, size);
+	if (memcmp(out + k % 4, ref + i, sizeof(uint32_t) * size) != 0) {
+	    printf("\nmismatch at %d of sfmt_fill_array32 size %d\n",
+		   i, size);
+	    exit(1);
+	}
+	i += size;
+    }
+    /* doubles and floats at even and odd positions */
+    sfmt_init_gen_rand(gen, 4321);
+    for (i = 0, k = 0; i + 2 * N32 + 2 < BLOCK_SIZE / 2; k++) {
+	double d;
+	float f;
+
+	for (j = 0; j < k % 3; j++, i++) {
+	    f = (float)(ref[i] >> 9) * (1.0f / 8388608.0f);
+	    if (sfmt_next_float(gen) != f) {
+		printf("\nmismatch at %d of sfmt_next_float\n", i);
+		exit(1);
+	    }
+	}
+	size = sizes[k % (sizeof(sizes) / sizeof(sizes[0]))] / 2;
+	sfmt_fill_array_double(gen, (double *)out, size);
+	for (j = 0; j < size; j++, i += 2) {
+	    d = (double)((ref[i] | ((uint64_t)ref[i + 1] << 32)) >> 12)
+		* (1.0 / 4503599627370496.0);
+	    if (((double *)out)[j] != d) {
+		printf("\nmismatch at %d of sfmt_fill_array_double size %d\n",
+		       i, size);
+		exit(1);
+	    }
+	}
+	size = sizes[(k + 1) % (sizeof(sizes) / sizeof(sizes[0]))];
+	sfmt_fill_array_float(gen, (float *)out, size);
+	for (j = 0; j < size; j++, i++) {
+	    f = (float)(ref[i] >> 9) * (1.0f / 8388608.0f);
+	    if (((float *)out)[j] != f) {
+		printf("\nmismatch at %d of sfmt_fill_array_float size %d\n",
+		       i, size);
+		exit(1);
+	    }
+	}
+    }
+    /* 64 bit outputs at even and odd positions */
+    sfmt_init_gen_rand(gen, 4321);
+    for (i = 0, k = 0; i + 2 * N32 + 2 < BLOCK_SIZE / 2; k++) {
+	for (j = 0; j < k % 3; j++, i++) {
+	    if (sfmt_next32(gen) != ref[i]) {
+		printf("\nmismatch at %d of sfmt_next32\n", i);
+		exit(1);
+	    }
+	}
+	if (sfmt_next64(gen) != (ref[i] | ((uint64_t)ref[i + 1] << 32))) {
+	    printf("\nmismatch at %d of sfmt_next64\n", i);
+	    exit(1);
+	}
+	i += 2;
+	size = sizes[k % (sizeof(sizes) / sizeof(sizes[0]))] / 2;
+	sfmt_fill_array64(gen, (uint64_t *)out + k % 2, size);
+	for (j = 0; j < size; j++, i += 2) {
+	    if (((uint64_t *)out)[k % 2 + j]
+		!= (ref[i] | ((uint64_t)ref[i + 1] << 32))) {
+		printf("\nmismatch at %d of sfmt_fill_array64 size %d\n",
+		       i, size);
+		exit(1);
+	    }
+	}
+    }
+    sfmt_free(gen);
+}
+
+/**
+ * This function checks sfmt_fill_array_bounded() and
+ * sfmt_fill_array_range() against sfmt_next_bounded() and
+ * sfmt_next_range() of another generator with the same seed, and
+ * sfmt_next_bounded() against the definition.  Nothing is printed
+ * unless a mismatch is found.
+ */
+void check_bounded(void) {
+    int i, j, k;
+    uint32_t r, lo;
+    uint64_t m;
+    uint32_t *ref = (uint32_t *)array1;
+    uint32_t *out = ref + BLOCK_SIZE / 2;
+    uint32_t bounds[] = {1, 2, 3, 6, 1000, 0x55555555U, 0x80000001U,
+			 0xffffffffU, 0};
+    sfmt_t *gen = sfmt_new(MEXP);
+    sfmt_t *gen2 = sfmt_new(MEXP);
+
+    /* the definition: the upper 32 bits of x * n, without x whose
+       lower 32 bits of x * n are less than 2^32 mod n */
+    init_gen_rand(5678, &sfmt[0]);
+    gen_rand_array((w128_t *)ref, BLOCK_SIZE / 8, &sfmt[0]);
+    sfmt_init_gen_rand(gen, 5678);
+    for (i = 0, j = 0; j < 10000; j++) {
+	do {
+	    m = (uint64_t)ref[i++] * 0x80000001U;
+	} while ((uint32_t)m < (0U - 0x80000001U) % 0x80000001U);
+	if (sfmt_next_bounded(gen, 0x80000001U) != (uint32_t)(m >> 32)) {
+	    printf("\nmismatch at %d of sfmt_next_bounded\n", j);
+	    exit(1);
+	}
+    }
+    sfmt_init_gen_rand(gen, 5678);
+    sfmt_init_gen_rand(gen2, 5678);
+    for (k = 0; k < (int)(sizeof(bounds) / sizeof(bounds[0])); k++) {
+	sfmt_fill_array_bounded(gen, out + k % 4, 3 * N32 + k, bounds[k]);
+	for (i = 0; i < 3 * N32 + k; i++) {
+	    r = sfmt_next_bounded(gen2, bounds[k]);
+	    if (out[k % 4 + i] != r || (bounds[k] != 0 && r >= bounds[k])) {
+		printf("\nmismatch at %d of sfmt_fill_array_bounded %u\n",
+		       i, bounds[k]);
+		exit(1);
+	    }
+	}
+	/* [lo, lo + bounds[k] - 1], without overflow */
+	lo = (0U - bounds[k]) < 10 ? 0U - bounds[k] : 10;
+	sfmt_next32(gen);
+	sfmt_next32(gen2);
+	sfmt_fill_array_range(gen, out, 1000 + k, lo, lo + bounds[k] - 1);
+	for (i = 0; i < 1000 + k; i++) {
+	    r = sfmt_next_range(gen2, lo, lo + bounds[k] - 1);
+	    if (out[i] != r || (bounds[k] != 0 && r - lo >= bounds[k])) {
+		printf("\nmismatch at %d of sfmt_fill_array_range %u\n",
+		       i, bounds[k]);
+		exit(1);
+	    }
+	}
+    }
+    sfmt_free(gen);
+    sfmt_free(gen2);
+}
+
+/**
+ * This function returns the next normal deviate of the ziggurat of
+ * sfmt-extstate-normal.c, written out in scalar code, from 32-bit
+ * outputs.
+ * @param ref 32-bit outputs
+ * @param pos the position of the next unused output in ref, even
+ * @return normal deviate
+ */
+double ref_normal(const uint32_t *ref, int *pos) {
+    uint64_t w;
+    int i;
+    double u, x, y;
+
+    for (;;) {
+	w = ref[*pos] | ((uint64_t)ref[*pos + 1] << 32);
+	*pos += 2;
+	i = (int)(w & 0xff);
+	u = (double)(w >> 12);
+	x = u * zig_w[i];
+	if (u < zig_k[i]) {
+	    break;
+	}
+	if (i == 0) {
+	    do {
+		u = (double)((ref[*pos] >> 12) |
+			     ((uint64_t)ref[*pos + 1] << 20));
+		x = -log(1.0 - u / 4503599627370496.0) / ZIG_R;
+		u = (double)((ref[*pos + 2] >> 12) |
+			     ((uint64_t)ref[*pos + 3] << 20));
+		y = -log(1.0 - u / 4503599627370496.0);
+		*pos += 4;
+	    } while (y + y < x * x);
+	    x += ZIG_R;
+	    break;
+	}
+	u = (double)((ref[*pos] >> 12) | ((uint64_t)ref[*pos + 1] << 20));
+	*pos += 2;
+	y = zig_f[i] + u / 4503599627370496.0 * (zig_f[i + 1] - zig_f[i]);
+	if (y < exp(-0.5 * x * x)) {
+	    break;
+	}
+    }
+    return (w & 0x100) ? -x : x;
+}
+
+/**
+ * This function checks sfmt_next_normal() against ref_normal(),
+ * sfmt_fill_array_normal() and sfmt_fill_array_normal_float() against
+ * sfmt_next_normal() and sfmt_next_normal_float() of another generator
+ * with the same seed at even and odd positions, and the mean, the
+ * variance and the tail of the deviates.  Nothing is printed unless a
+ * mismatch is found.
+ */
+void check_normal(void) {
+    int i, j, k, pos;
+    int tail;
+    double x, sum, sum2;
+    uint32_t *ref = (uint32_t *)array1;
+    double *out = (double *)(ref + BLOCK_SIZE / 2);
+    float *outf = (float *)out;
+    sfmt_t *gen = sfmt_new(MEXP);
+    sfmt_t *gen2 = sfmt_new(MEXP);
+
+    init_gen_rand(8765, &sfmt[0]);
+    gen_rand_array((w128_t *)ref, BLOCK_SIZE / 8, &sfmt[0]);
+    sfmt_init_gen_rand(gen, 8765);
+    for (i = 0, pos = 0; i < 10000; i++) {
+	if (sfmt_next_normal(gen) != ref_normal(ref, &pos)) {
+	    printf("\nmismatch at %d of sfmt_next_normal\n", i);
+	    exit(1);
+	}
+    }
+    sfmt_init_gen_rand(gen, 8765);
+    sfmt_init_gen_rand(gen2, 8765);
+    for (k = 0; k < 8; k++) {
+	if (k & 1) {
+	    sfmt_next32(gen);
+	    sfmt_next32(gen2);
+	}
+	sfmt_fill_array_normal(gen, out, 3 * N32 + k);
+	for (i = 0; i < 3 * N32 + k; i++) {
+	    if (out[i] != sfmt_next_normal(gen2)) {
+		printf("\nmismatch at %d of sfmt_fill_array_normal %d\n",
+		       i, k);
+		exit(1);
+	    }
+	}
+	sfmt_fill_array_normal_float(gen, outf, 1 + k * 3);
+	for (i = 0; i < 1 + k * 3; i++) {
+	    if (outf[i] != sfmt_next_normal_float(gen2)) {
+		printf("\nmismatch at %d of sfmt_fill_array_normal_float %d\n",
+		       i, k);
+		exit(1);
+	    }
+	}
+	sfmt_fill_array_normal_float(gen, outf, 3 * N32 + k);
+	for (i = 0; i < 3 * N32 + k; i++) {
+	    if (outf[i] != sfmt_next_normal_float(gen2)) {
+		printf("\nmismatch at %d of sfmt_fill_array_normal_float %d\n",
+		       i, k);
+		exit(1);
+	    }
+	}
+    }
+    /* 10^6 deviates: the errors are less than 5 sigma */
+    sum = sum2 = 0;
+    tail = 0;
+    for (j = 0; j < 50; j++) {
+	sfmt_fill_array_normal(gen, out, 20000);
+	for (i = 0; i < 20000; i++) {
+	    x = out[i];
+	    sum += x;
+	    sum2 += x * x;
+	    if (x > ZIG_R || x < -ZIG_R) {
+		tail++;
+	    }
+	}
+    }
+    if (fabs(sum / 1000000) > 0.005 || fabs(sum2 / 1000000 - 1) > 0.007
+	|| tail < 180 || tail > 340) {
+	printf("\nnormal deviates out of range: mean %f variance %f tail %d\n",
+	       sum / 1000000, sum2 / 1000000, tail);
+	exit(1);
+    }
+    sfmt_free(gen);
+    sfmt_free(gen2);
+}
+
+/**
+ * This function checks sfmt_fill_array32_lanes() against
+ * gen_rand_array() for numbers of lanes with and without a SIMD path,
+ * rows which straddle refills, odd positions of the sequence and odd
+ * offsets of the lanes.  Nothing is printed unless a mismatch is found.
+ */
+void check_lanes(void) {
+    int i, j, k, r;
+    int count, size;
+    uint32_t *ref = (uint32_t *)array1;
+    uint32_t *out = ref + BLOCK_SIZE / 2;
+    uint32_t *lanes[12];
+    int counts[] = {1, 2, 3, 4, 5, 8, 12, 7};
+    int totals[] = {5, 101, N32 / 3 + 1, 2 * N32 + 3, 40};
+    sfmt_t *gen = sfmt_new(MEXP);
+
+    init_gen_rand(4321, &sfmt[0]);
+    gen_rand_array((w128_t *)ref, BLOCK_SIZE / 8, &sfmt[0]);
+    sfmt_init_gen_rand(gen, 4321);
+    for (i = 0, k = 0; k < 40; k++) {
+	/* 0 to 2 scalar draws, then lanes at an offset of 0 to 3 */
+	for (j = 0; j < k % 3; j++, i++) {
+	    if (sfmt_next32(gen) != ref[i]) {
+		printf("\nmismatch at %d of sfmt_next32\n", i);
+		exit(1);
+	    }
+	}
+	count = counts[k % 8];
+	size = totals[k % 5] / count + 1;
+	if (i + count * size >= BLOCK_SIZE / 2) {
+	    break;
+	}
+	for (j = 0; j < count; j++) {
+	    lanes[j] = out + j * (size + 1) + k % 4;
+	}
+	sfmt_fill_array32_lanes(gen, lanes, count, size);
+	for (r = 0; r < size; r++) {
+	    for (j = 0; j < count; j++) {
+		if (lanes[j][r] != ref[i + r * count + j]) {
+		    printf("\nmismatch at %d of sfmt_fill_array32_lanes"
+			   " %d lanes\n", i + r * count + j, count);
+		    exit(1);
+		}
+	    }
+	}
+	i += count * size;
+    }
+    sfmt_free(gen);
+}
+
+/**
+ * This function checks sfmt_jump() against gen_rand_all() for steps
+ * below and above the degree of the minimal polynomial, and two jumps
+ * of 2^64 against one of 2^65, and that sfmt_min_poly() rejects a
+ * parameter set of 4 128-bit integers whose polynomial is short of
+ * degree 512.  The jump polynomials take time in the square of 128N, so
+ * this is skipped for MEXP above 19937.  Nothing is printed unless a
+ * mismatch is found.
+ */
+void check_jump(void) {
+#if MEXP <= 19937
+    int i, k, q, r;
+    uint32_t steps[] = {1, 3, N, N + 5, 2 * 128 * N + 7};
+    uint32_t pow64[] = {0, 0, 1};
+    uint32_t pow65[] = {0, 0, 2};
+    uint32_t ini[] = {0x1234, 0x5678, 0x9abc, 0xdef0};
+    uint64_t m[2 * 4 + 1];
+    sfmt_params_t params;
+    jump_poly *p, *p2;
+
+    params = *sfmt_get_params(MEXP);
+    params.n = 4;
+    params.n32 = 16;
+    params.pos1 = 1;
+    if (sfmt_min_poly(&params, m) != 512) {
+	printf("\nsfmt_min_poly(n = 4) failed\n");
+	exit(1);
+    }
+    memset(params.msk, 0, sizeof(params.msk));
+    if (sfmt_min_poly(&params, m) != -2) {
+	printf("\nsfmt_min_poly() accepted a short polynomial\n");
+	exit(1);
+    }
+    if (sfmt_new_jump_poly(MEXP + 1, steps, 1) != NULL) {
+	printf("\nsfmt_new_jump_poly(%d) failed\n", MEXP + 1);
+	exit(1);
+    }
+    for (k = 0; k < (int)(sizeof(steps) / sizeof(steps[0])); k++) {
+	p = sfmt_new_jump_poly(MEXP, &steps[k], 1);
+	init_gen_rand(1234, &sfmt[0]);
+	if (p == NULL || sfmt_jump(&sfmt[0], p) != 0) {
+	    printf("\nsfmt_jump(%u) failed\n", steps[k]);
+	    exit(1);
+	}
+	/* the table moved steps[k] = q N + r 128-bit integers ahead */
+	q = steps[k] / N;
+	r = steps[k] % N;
+	init_gen_rand(1234, xsfmt[0]);
+	for (i = 0; i < q; i++) {
+	    gen_rand_all(xsfmt[0]);
+	}
+	memcpy(xsfmt[1], xsfmt[0], sizeof(sfmt));
+	gen_rand_all(xsfmt[1]);
+	if (memcmp(&sfmt[0], &xsfmt[0][r], sizeof(w128_t) * (N - r)) != 0
+	    || memcmp(&sfmt[N - r], xsfmt[1], sizeof(w128_t) * r) != 0) {
+	    printf("\nmismatch of sfmt_jump(%u)\n", steps[k]);
+	    exit(1);
+	}
+	sfmt_free_jump_poly(p);
+    }
+    p = sfmt_new_jump_poly(MEXP, pow64, 3);
+    p2 = sfmt_new_jump_poly(MEXP, pow65, 3);
+    init_by_array(ini, 4, &sfmt[0]);
+    sfmt_jump(&sfmt[0], p);
+    sfmt_jump(&sfmt[0], p);
+    init_by_array(ini, 4, xsfmt[0]);
+    sfmt_jump(xsfmt[0], p2);
+    if (memcmp(&sfmt[0], xsfmt[0], sizeof(sfmt)) != 0) {
+	printf("\nmismatch of sfmt_jump(2^64) twice and sfmt_jump(2^65)\n");
+	exit(1);
+    }
+    sfmt_free_jump_poly(p);
+    sfmt_free_jump_poly(p2);
+#endif
+}
+
+/**
+ * This function replaces size bytes of a file at an offset, and exits
+ * if it cannot.
+ * @param path the file name
+ * @param offset the offset of the bytes
+ * @param old where the bytes replaced are stored, or NULL
+ * @param new the new bytes
+ * @param size the number of the bytes
+ */
+void patch_file(const char *path, long offset, void *old, const void *new,
+		size_t size) {
+    FILE *fp = fopen(path, "r+b");
+
+    if (fp == NULL
+	|| (old != NULL && (fseek(fp, offset, SEEK_SET) != 0
+			    || fread(old, 1, size, fp) != size))
+	|| fseek(fp, offset, SEEK_SET) != 0
+	|| fwrite(new, 1, size, fp) != size) {
+	printf("\ncannot patch %s\n", path);
+	exit(1);
+    }
+    if (fclose(fp) != 0) {
+	printf("\ncannot patch %s\n", path);
+	exit(1);
+    }
+}
+
+/**
+ * This function checks a jump table file of sfmt_write_jump_table()
+ * against sfmt_new_jump_poly(), the substreams against the jumps one
+ * by one, the seeded substreams of sfmt_init_*_substream() against
+ * those, sfmt_split() against sfmt_split_path(), and
+ * sfmt_open_jump_table() against a table of another parameter set, a
+ * wrong power of 2, a wrong degree and a wrong identification string.
+ * This is skipped for MEXP above 19937, as check_jump().  Nothing is
+ * printed unless a mismatch is found.
+ */
+void check_jump_table(void) {
+#if MEXP <= 19937
+    int i;
+    char path[64];
+    uint32_t pow64[] = {0, 0, 1};
+    uint32_t ini[] = {0x1234, 0x5678, 0x9abc, 0xdef0};
+    uint32_t kmin, bad_kmin;
+    uint64_t degree, bad;
+    jump_poly *p;
+    const jump_poly *q;
+    sfmt_jump_table *table;
+
+    sprintf(path, "test-jump-M%d.bin", MEXP);
+    if (sfmt_write_jump_table(path, MEXP, 60, 70) != 0
+	|| (table = sfmt_open_jump_table(path, MEXP)) == NULL) {
+	printf("\nsfmt_write_jump_table(%d) failed\n", MEXP);
+	exit(1);
+    }
+    if (sfmt_open_jump_table(path, MEXP == 607 ? 1279 : 607) != NULL
+	|| sfmt_jump_table_poly(table, 59) != NULL
+	|| sfmt_jump_table_poly(table, 71) != NULL) {
+	printf("\nsfmt_open_jump_table(%d) failed\n", MEXP);
+	exit(1);
+    }
+    /* 2^64, and the substream 5 of 2^64 against 5 jumps */
+    p = sfmt_new_jump_poly(MEXP, pow64, 3);
+    q = sfmt_jump_table_poly(table, 64);
+    if (q == NULL || q->degree != p->degree
+	|| memcmp(q->coef, p->coef, sizeof(uint64_t) * (p->degree / 64 + 1))
+	!= 0) {
+	printf("\nmismatch of the jump table of 2^64\n");
+	exit(1);
+    }
+    init_gen_rand(1234, &sfmt[0]);
+    for (i = 0; i < 5; i++) {
+	sfmt_jump(&sfmt[0], p);
+    }
+    init_gen_rand(1234, xsfmt[2]);
+    init_gen_rand(1234, xsfmt[0]);
+    if (sfmt_jump_substream(xsfmt[0], table, 64, 5) != 0
+	|| memcmp(&sfmt[0], xsfmt[0], sizeof(sfmt)) != 0
+	|| sfmt_jump_substream(xsfmt[0], table, 64, 128) == 0) {
+	printf("\nmismatch of sfmt_jump_substream()\n");
+	exit(1);
+    }
+    memcpy(xsfmt[1], &sfmt[0], sizeof(sfmt));
+    /* the substreams of a seed, whatever their number */
+    init_by_array(ini, 4, xsfmt[0]);
+    sfmt_jump_substream(xsfmt[0], table, 60, 3);
+    if (sfmt_init_gen_rand_substream(&sfmt[0], table, 64, 8, 5, 1234) != 0
+	|| memcmp(&sfmt[0], xsfmt[1], sizeof(sfmt)) != 0
+	|| sfmt_init_by_array_substream(&sfmt[0], table, 60, 1 << 20, 3,
+					ini, 4) != 0
+	|| memcmp(&sfmt[0], xsfmt[0], sizeof(sfmt)) != 0
+	|| sfmt_init_gen_rand_substream(&sfmt[0], table, 64, 1, 0, 1234) != 0
+	|| memcmp(&sfmt[0], xsfmt[2], sizeof(sfmt)) != 0
+	|| sfmt_init_gen_rand_substream(&sfmt[0], table, 64, 5, 5, 1234) == 0
+	|| sfmt_init_gen_rand_substream(&sfmt[0], table, 64, 0, 0, 1234) == 0
+	|| sfmt_init_gen_rand_substream(&sfmt[0], table, MEXP - 2, 4, 1,
+					1234) == 0) {
+	printf("\nmismatch of sfmt_init_*_substream()\n");
+	exit(1);
+    }
+    /* a tree of 2^70: the nodes 10, 11 and 101 by splits and by paths */
+    init_gen_rand(1234, xsfmt[0]);
+    if (sfmt_split(xsfmt[0], xsfmt[1], table, 70) != 0
+	|| sfmt_split(xsfmt[1], xsfmt[2], table, 69) != 0
+	|| sfmt_split(xsfmt[1], xsfmt[3], table, 68) != 0
+	|| sfmt_split(xsfmt[0], &sfmt[0], table, 60) == 0) {
+	printf("\nsfmt_split() failed\n");
+	exit(1);
+    }
+    for (i = 0; i < 4; i++) {
+	uint64_t paths[] = {0, 2, 3, 5};
+	int depths[] = {0, 2, 2, 3};
+
+	init_gen_rand(1234, &sfmt[0]);
+	if (sfmt_split_path(&sfmt[0], table, 70, paths[i], depths[i]) != 0
+	    || memcmp(&sfmt[0], xsfmt[i], sizeof(sfmt)) != 0) {
+	    printf("\nmismatch of sfmt_split_path(%d)\n", (int)paths[i]);
+	    exit(1);
+	}
+    }
+    if (sfmt_split_path(&sfmt[0], table, 70, 1, 11) == 0
+	|| sfmt_split_path(&sfmt[0], table, 70, 4, 2) == 0) {
+	printf("\nsfmt_split_path() accepted a wrong path\n");
+	exit(1);
+    }
+    sfmt_free_jump_poly(p);
+    sfmt_close_jump_table(table);
+    /* a power of 2 past INT_MAX, the kmin of the header at 16 */
+    bad_kmin = 0x80000000U;
+    patch_file(path, 16, &kmin, &bad_kmin, sizeof(kmin));
+    if (sfmt_open_jump_table(path, MEXP) != NULL) {
+	printf("\nsfmt_open_jump_table() accepted a wrong power of 2\n");
+	exit(1);
+    }
+    patch_file(path, 16, NULL, &kmin, sizeof(kmin));
+    /* a degree past the coefficients, after the header of 128 bytes */
+    bad = (uint64_t)1 << 40;
+    patch_file(path, 128, &degree, &bad, sizeof(degree));
+    if (sfmt_open_jump_table(path, MEXP) != NULL) {
+	printf("\nsfmt_open_jump_table() accepted a wrong degree\n");
+	exit(1);
+    }
+    patch_file(path, 128, NULL, &degree, sizeof(degree));
+    if ((table = sfmt_open_jump_table(path, MEXP)) == NULL) {
+	printf("\nsfmt_open_jump_table(%d) failed\n", MEXP);
+	exit(1);
+    }
+    sfmt_close_jump_table(table);
+    /* a table of another identification string, at 32 */
+    patch_file(path, 32, NULL, "X", 1);
+    if (sfmt_open_jump_table(path, MEXP) != NULL) {
+	printf("\nsfmt_open_jump_table() accepted a wrong idstring\n");
+	exit(1);
+    }
+    remove(path);
+#endif
+}
+
+/**
+ * This function checks sfmt_pool_gen_rand_array() against
+ * gen_rand_array(), for arrays of one chunk to many chunks with a
+ * remainder, and sfmt_pool_fill_array32() against sfmt_fill_array32()
+ * at odd positions and offsets.  The outputs and the state tables left
+ * must be the same.  This is skipped for MEXP above 19937, as
+ * check_jump().  Nothing is printed unless a mismatch is found.
+ */
+void check_pool(void) {
+#if MEXP <= 19937
+    int i, j, k;
+    w128_t *ref = (w128_t *)array1;
+    w128_t *out = ref + BLOCK_SIZE / 8;
+    uint32_t *ref32 = (uint32_t *)ref;
+    uint32_t *out32 = (uint32_t *)out;
+    int sizes[] = {N, 2 * (N + 3), 7 * (N + 3) + 5, BLOCK_SIZE / 8};
+    int sizes32[] = {40 * (N + 3) * 4 + 1, 5, N32 * 20 + 3, N32};
+    sfmt_pool *pool = sfmt_new_pool(MEXP, 4, N + 3);
+    sfmt_t *gen = sfmt_new(MEXP);
+    sfmt_t *gen2 = sfmt_new(MEXP);
+
+    if (pool == NULL || sfmt_new_pool(MEXP, 4, N - 1) != NULL
+	|| sfmt_new_pool(MEXP, 0, N) != NULL) {
+	printf("\nsfmt_new_pool(%d) failed\n", MEXP);
+	exit(1);
+    }
+    init_gen_rand(4321, &sfmt[0]);
+    init_gen_rand(4321, xsfmt[0]);
+    for (k = 0; k < (int)(sizeof(sizes) / sizeof(sizes[0])); k++) {
+	gen_rand_array(ref, sizes[k], &sfmt[0]);
+	sfmt_pool_gen_rand_array(pool, out, sizes[k], xsfmt[0]);
+	if (memcmp(ref, out, sizeof(w128_t) * sizes[k]) != 0
+	    || memcmp(&sfmt[0], xsfmt[0], sizeof(sfmt)) != 0) {
+	    printf("\nmismatch of sfmt_pool_gen_rand_array size %d\n",
+		   sizes[k]);
+	    exit(1);
+	}
+    }
+    sfmt_init_gen_rand(gen, 4321);
+    sfmt_init_gen_rand(gen2, 4321);
+    for (k = 0; k < 12; k++) {
+	/* 0 to 2 scalar draws, then a fill at an offset of 0 to 3 */
+	for (j = 0; j < k % 3; j++) {
+	    sfmt_next32(gen);
+	    sfmt_next32(gen2);
+	}
+	i = sizes32[k % 4];
+	sfmt_fill_array32(gen, ref32 + k % 4, i);
+	sfmt_pool_fill_array32(pool, gen2, out32 + k % 4, i);
+	if (memcmp(ref32 + k % 4, out32 + k % 4, sizeof(uint32_t) * i) != 0
+	    || sfmt_next32(gen) != sfmt_next32(gen2)) {
+	    printf("\nmismatch of sfmt_pool_fill_array32 size %d\n", i);
+	    exit(1);
+	}
+    }
+    sfmt_free(gen);
+    sfmt_free(gen2);
+    sfmt_free_pool(pool);
+#endif
+}
+
+/**
+ * This function checks the output of the rings of producer threads,
+ * a small one which wraps around and sleeps often and two of blocks of
+ * three tables, against that of a generator, and the generators given
+ * back by sfmt_free_ring() at the end of a block and in the middle.  Nothing is printed unless a mismatch is
+ * found.
+ */
+void check_ring(void) {
+    int i, k, end;
+    int counts[] = {2, 4, 3};
+    int tables[] = {1, 3, 3};
+    sfmt_ring *ring;
+    sfmt_t *gen = sfmt_new(MEXP);
+    sfmt_t *gen2 = sfmt_new(MEXP);
+
+    sfmt_init_gen_rand(gen, 4321);
+    sfmt_init_gen_rand(gen2, 4321);
+    if (sfmt_new_ring(gen2, 1, 1, -1) != NULL
+	|| sfmt_new_ring(gen2, 2, 0, -1) != NULL) {
+	printf("\nsfmt_new_ring(%d) failed\n", MEXP);
+	exit(1);
+    }
+    for (i = 0; i < 5; i++) {
+	sfmt_next32(gen);
+	sfmt_next32(gen2);
+    }
+    for (k = 0; k < 3; k++) {
+	ring = sfmt_new_ring(gen2, counts[k], tables[k], k == 1 ? 0 : -1);
+	if (ring == NULL) {
+	    printf("\nsfmt_new_ring(%d) failed\n", MEXP);
+	    exit(1);
+	}
+	/* the first ring is read by mixed 32- and 64-bit outputs, and the
+	   others are left at the end of their second blocks and in the
+	   second table of their second blocks */
+	if (k == 0) {
+	    end = N32 * 40 + 7;
+	} else if (k == 1) {
+	    end = ring->size32 - ring->idx + N32 * 6;
+	} else {
+	    end = ring->size32 - ring->idx + N32 * 4 + 11;
+	}
+	for (i = 0; i < end; i++) {
+	    if (k == 0 && i % 7 == 3
+		? sfmt_ring_next64(ring) != sfmt_next64(gen)
+		: sfmt_ring_next32(ring) != sfmt_next32(gen)) {
+		printf("\nmismatch at %d of ring %d\n", i, k);
+		exit(1);
+	    }
+	}
+	sfmt_free_ring(ring, gen2);
+	for (i = 0; i < N32 * 2; i++) {
+	    if (sfmt_next32(gen) != sfmt_next32(gen2)) {
+		printf("\nmismatch at %d after ring %d\n", i, k);
+		exit(1);
+	    }
+	}
+    }
+    sfmt_free(gen);
+    sfmt_free(gen2);
+}
+
+/**
+ * This function checks the output of incremental generators with
+ * slices of 1, 5 and N, made from a new generator and from ones in the
+ * middle of a table, against that of the generator.  Nothing is printed
+ * unless a mismatch is found.
+ */
+void check_inc(void) {
+    int i, k;
+    int slices[] = {1, 5, N};
+    sfmt_inc_t *inc;
+    sfmt_t *gen = sfmt_new(MEXP);
+
+    sfmt_init_gen_rand(gen, 4321);
+    if (sfmt_new_inc(gen, 0) != NULL || sfmt_new_inc(gen, N + 1) != NULL) {
+	printf("\nsfmt_new_inc() took a slice out of range\n");
+	exit(1);
+    }
+    for (k = 0; k < 3; k++) {
+	inc = sfmt_new_inc(gen, slices[k]);
+	if (inc == NULL) {
+	    printf("\nsfmt_new_inc(%d) failed\n", MEXP);
+	    exit(1);
+	}
+	for (i = 0; i < N32 * 10 + 7; i++) {
+	    if (i % 7 == 3
+		? sfmt_inc_next64(inc) != sfmt_next64(gen)
+		: sfmt_inc_next32(inc) != sfmt_next32(gen)) {
+		printf("\nmismatch at %d of sfmt_inc_next32 %d\n", i, k);
+		exit(1);
+	    }
+	}
+	sfmt_free_inc(inc);
+	for (i = 0; i < 5; i++) {
+	    sfmt_next32(gen);
+	}
+    }
+    sfmt_free(gen);
+}
+
+/**
+ * This function checks the output of incremental generators with a
+ * watermark against that of generators: one made by sfmt_inc_idle()
+ * now and then, one made by the reader alone, and three served by a
+ * helper thread and read in turn.  Nothing is printed unless a mismatch
+ * is found.
+ */
+void check_watermark(void) {
+    int i, k;
+    sfmt_inc_t *inc[3];
+    sfmt_t *gen[3];
+    sfmt_helper *helper;
+    clock_t start;
+
+    for (k = 0; k < 3; k++) {
+	gen[k] = sfmt_new(MEXP);
+	sfmt_init_gen_rand(gen[k], 4321 + k);
+	for (i = 0; i < k * 5; i++) {
+	    sfmt_next32(gen[k]);
+	}
+	inc[k] = sfmt_new_inc(gen[k], 4);
+	if (inc[k] == NULL) {
+	    printf("\nsfmt_new_inc(%d) failed\n", MEXP);
+	    exit(1);
+	}
+    }
+    if (sfmt_inc_set_watermark(inc[0], N32, NULL) != -1
+	|| sfmt_inc_set_watermark(inc[0], -2, NULL) != -1
+	|| sfmt_inc_set_watermark(inc[0], N32 / 2, NULL) != 0
+	|| sfmt_inc_set_watermark(inc[1], 0, NULL) != 0) {
+	printf("\nsfmt_inc_set_watermark failed\n");
+	exit(1);
+    }
+    for (i = 0; i < N32 * 5 + 7; i++) {
+	if (i % 100 == 99) {
+	    sfmt_inc_idle(inc[0], 3);
+	}
+	for (k = 0; k < 2; k++) {
+	    if (sfmt_inc_next32(inc[k]) != sfmt_next32(gen[k])) {
+		printf("\nmismatch at %d of sfmt_inc_idle %d\n", i, k);
+		exit(1);
+	    }
+	}
+    }
+    helper = sfmt_new_helper(-1);
+    if (helper == NULL) {
+	printf("\nsfmt_new_helper failed\n");
+	exit(1);
+    }
+    for (k = 0; k < 3; k++) {
+	if (sfmt_inc_set_watermark(inc[k], k * N32 / 3, helper) != 0) {
+	    printf("\nsfmt_inc_set_watermark failed\n");
+	    exit(1);
+	}
+    }
+    for (i = 0; i < N32 * 10 + 7; i++) {
+	for (k = 0; k < 3; k++) {
+	    if (i % (N32 / 4) == 0 && inc[k]->idx > k * N32 / 3 + 2) {
+		/* give the helper up to a second to make next */
+		start = clock();
+		while (__atomic_load_n(&inc[k]->made, __ATOMIC_ACQUIRE) < N
+		       && clock() - start < CLOCKS_PER_SEC) {
+		}
+	    }
+	    if (i % 7 == 3
+		? sfmt_inc_next64(inc[k]) != sfmt_next64(gen[k])
+		: sfmt_inc_next32(inc[k]) != sfmt_next32(gen[k])) {
+		printf("\nmismatch at %d of sfmt_new_helper %d\n", i, k);
+		exit(1);
+	    }
+	}
+    }
+    /* back to slices while the helper may be making next */
+    if (sfmt_inc_set_watermark(inc[2], -1, NULL) != 0) {
+	printf("\nsfmt_inc_set_watermark failed\n");
+	exit(1);
+    }
+    for (i = 0; i < N32 * 2; i++) {
+	if (sfmt_inc_next32(inc[2]) != sfmt_next32(gen[2])) {
+	    printf("\nmismatch at %d of sfmt_inc_set_watermark\n", i);
+	    exit(1);
+	}
+    }
+    for (k = 0; k < 3; k++) {
+	sfmt_free_inc(inc[k]);
+	sfmt_free(gen[k]);
+    }
+    sfmt_free_helper(helper);
+}
+
+/** a thread claiming outputs of a shared generator in check_shared() */
+struct CLAIM_T {
+    /** the shared generator */
+    sfmt_shared *shared;
+    /** the outputs, stored at their positions in the stream */
+    uint32_t *out;
+    /** the outputs of a claim, 1.5 N32 */
+    uint32_t *buf;
+    /** the thread stops after it claims this position */
+    uint64_t total;
+    /** the seed of the sizes of the claims */
+    uint32_t seed;
+    /** the end of the last claim of the thread */
+    uint64_t end;
+};
+
+/**
+ * This function claims outputs of a shared generator of random sizes
+ * up to 1.5 N32 until it claims the total.
+ * @param arg the claims, a struct CLAIM_T
+ * @return NULL
+ */
+void *claim_shared(void *arg) {
+    struct CLAIM_T *c = arg;
+    uint64_t pos;
+    int size;
+
+    do {
+	c->seed = c->seed * 1664525 + 1013904223;
+	size = (c->seed >> 8) % (N32 * 3 / 2) + 1;
+	pos = sfmt_shared_fill_array32(c->shared, c->buf, size);
+	memcpy(c->out + pos, c->buf, sizeof(uint32_t) * size);
+	c->end = pos + size;
+    } while (pos < c->total);
+    return NULL;
+}
+
+/**
+ * This function checks the output of shared generators claimed by four
+ * threads at once against that of a generator, with a ring of two
+ * blocks of one table and of three of two tables from the middle of a
+ * table, and the generator given back after them.  Nothing is printed
+ * unless a mismatch is found.
+ */
+void check_shared(void) {
+    int i, j, k;
+    uint64_t total = N32 * 20;
+    uint64_t end;
+    uint32_t *out;
+    sfmt_shared *shared;
+    struct CLAIM_T claims[4];
+    pthread_t threads[4];
+    sfmt_t *gen = sfmt_new(MEXP);
+    sfmt_t *gen2 = sfmt_new(MEXP);
+    int config[2][2] = {{2, 1}, {3, 2}};
+
+    out = malloc(sizeof(uint32_t) * (total + N32 * 6));
+    if (out == NULL) {
+	printf("\ncan't allocate memory.\n");
+	exit(1);
+    }
+    sfmt_init_gen_rand(gen, 5678);
+    sfmt_init_gen_rand(gen2, 5678);
+    for (k = 0; k < 2; k++) {
+	shared = sfmt_new_shared(gen, config[k][0], config[k][1]);
+	if (shared == NULL) {
+	    printf("\nsfmt_new_shared(%d) failed\n", MEXP);
+	    exit(1);
+	}
+	for (j = 0; j < 4; j++) {
+	    claims[j].shared = shared;
+	    claims[j].out = out;
+	    claims[j].buf = malloc(sizeof(uint32_t) * (N32 * 3 / 2));
+	    claims[j].total = total;
+	    claims[j].seed = j * 7 + k;
+	    claims[j].end = 0;
+	    if (claims[j].buf == NULL
+		|| pthread_create(&threads[j], NULL, claim_shared,
+				  &claims[j]) != 0) {
+		printf("\ncan't start a thread.\n");
+		exit(1);
+	    }
+	}
+	end = 0;
+	for (j = 0; j < 4; j++) {
+	    pthread_join(threads[j], NULL);
+	    free(claims[j].buf);
+	    if (claims[j].end > end) {
+		end = claims[j].end;
+	    }
+	}
+	sfmt_free_shared(shared, gen);
+	for (i = 0; (uint64_t)i < end; i++) {
+	    if (out[i] != sfmt_next32(gen2)) {
+		printf("\nmismatch at %d of sfmt_shared_fill_array32 %d\n",
+		       i, k);
+		exit(1);
+	    }
+	}
+	for (i = 0; i < 5; i++) {
+	    if (sfmt_next32(gen) != sfmt_next32(gen2)) {
+		printf("\nmismatch at %d of sfmt_free_shared %d\n", i, k);
+		exit(1);
+	    }
+	}
+    }
+    free(out);
+    sfmt_free(gen);
+    sfmt_free(gen2);
+}
+
+/** a thread taking its generator in check_local() */
+struct LOCAL_USE_T {
+    /** the set of per-thread generators */
+    sfmt_local *local;
+    /** the generator of the thread, or NULL */
+    sfmt_t *gen;
+    /** the first outputs of the generator */
+    uint32_t out[100];
+};
+
+/**
+ * This function takes the generator of the thread from a set of
+ * per-thread generators, and stores its first outputs.
+ * @param arg the set and the outputs, a struct LOCAL_USE_T
+ * @return NULL
+ */
+void *use_local(void *arg) {
+    struct LOCAL_USE_T *use = arg;
+    int i;
+
+    use->gen = sfmt_local_get(use->local);
+    if (use->gen == NULL) {
+	return NULL;
+    }
+    if (sfmt_local_get(use->local) != use->gen) {
+	use->gen = NULL;
+	return NULL;
+    }
+    for (i = 0; i < 100; i++) {
+	use->out[i] = sfmt_next32(use->gen);
+    }
+    return NULL;
+}
+
+/**
+ * This function checks that the threads of a set of per-thread
+ * generators get generators of their own, page aligned, of distinct
+ * substreams of the seed, and that a thread gets none when all the
+ * substreams are taken.  Nothing is printed unless a mismatch is
+ * found.
+ */
+void check_local(void) {
+#if MEXP <= 19937
+    int i, j, k;
+    char path[64];
+    int taken[4] = {0, 0, 0, 0};
+    long page = sysconf(_SC_PAGESIZE);
+    sfmt_jump_table *table;
+    sfmt_local *local;
+    struct LOCAL_USE_T uses[5];
+    pthread_t threads[5];
+    sfmt_t *ref = sfmt_new(MEXP);
+
+    sprintf(path, "test-local-M%d.bin", MEXP);
+    if (sfmt_write_jump_table(path, MEXP, 8, 9) != 0
+	|| (table = sfmt_open_jump_table(path, MEXP)) == NULL) {
+	printf("\nsfmt_write_jump_table(%d) failed\n", MEXP);
+	exit(1);
+    }
+    local = sfmt_new_local(table, 8, 4, 4321);
+    if (local == NULL || sfmt_new_local(table, 8, 0, 4321) != NULL) {
+	printf("\nsfmt_new_local(%d) failed\n", MEXP);
+	exit(1);
+    }
+    for (j = 0; j < 5; j++) {
+	uses[j].local = local;
+    }
+    /* three threads at once, the caller, and one more when all are taken */
+    for (j = 0; j < 3; j++) {
+	if (pthread_create(&threads[j], NULL, use_local, &uses[j]) != 0) {
+	    printf("\ncan't start a thread.\n");
+	    exit(1);
+	}
+    }
+    for (j = 0; j < 3; j++) {
+	pthread_join(threads[j], NULL);
+    }
+    use_local(&uses[3]);
+    if (pthread_create(&threads[4], NULL, use_local, &uses[4]) != 0) {
+	printf("\ncan't start a thread.\n");
+	exit(1);
+    }
+    pthread_join(threads[4], NULL);
+    if (uses[4].gen != NULL) {
+	printf("\nsfmt_local_get() gave more generators than substreams\n");
+	exit(1);
+    }
+    for (j = 0; j < 4; j++) {
+	if (uses[j].gen == NULL
+	    || (uintptr_t)uses[j].gen % page != 0
+	    || (uintptr_t)uses[j].gen->state % 64 != 0) {
+	    printf("\nsfmt_local_get() failed in thread %d\n", j);
+	    exit(1);
+	}
+	for (k = 0; k < 4; k++) {
+	    sfmt_init_gen_rand_substream(ref->state, table, 8, 4, k, 4321);
+	    ref->idx = N32;
+	    for (i = 0; i < 100 && uses[j].out[i] == sfmt_next32(ref); i++) {
+	    }
+	    if (i == 100) {
+		break;
+	    }
+	}
+	if (k == 4 || taken[k] || (j == 3 && k != 3)) {
+	    printf("\nmismatch of sfmt_local_get() in thread %d\n", j);
+	    exit(1);
+	}
+	taken[k] = 1;
+    }
+    sfmt_free_local(local);
+    sfmt_close_jump_table(table);
+    remove(path);
+    sfmt_free(ref);
+#endif
+}
+
+/**
+ * This function checks sfmt_discard() against sfmt_fill_array32() of
+ * another generator for skips within the table, over a few tables and
+ * over more than 128N tables with the jumps, at odd positions.  A skip
+ * of 10^12 is checked against a skip of 10^12 - 10^6 - 3 followed by
+ * 10^6 + 3 outputs, and a failed skip of 2^62 not to move the
+ * generator.  This is skipped for MEXP above 19937, as check_jump().
+ * Nothing is printed unless a mismatch is found.
+ */
+void check_discard(void) {
+#if MEXP <= 19937
+    int i, k;
+    char path[64];
+    uint32_t *out = (uint32_t *)array1;
+    int out_size = BLOCK_SIZE;
+    uint64_t skips[] = {0, 1, 5, N32 - 1, N32, 3 * N32 + 5,
+			(uint64_t)2 * 128 * N * N32 + 77};
+    uint64_t n;
+    sfmt_jump_table *table;
+    sfmt_t *gen = sfmt_new(MEXP);
+    sfmt_t *gen2 = sfmt_new(MEXP);
+
+    sprintf(path, "test-discard-M%d.bin", MEXP);
+    if (sfmt_write_jump_table(path, MEXP, 0, 40) != 0
+	|| (table = sfmt_open_jump_table(path, MEXP)) == NULL) {
+	printf("\nsfmt_write_jump_table(%d) failed\n", MEXP);
+	exit(1);
+    }
+    sfmt_init_gen_rand(gen, 4321);
+    sfmt_init_gen_rand(gen2, 4321);
+    for (k = 0; k < 21; k++) {
+	for (i = 0; i < k % 3; i++) {
+	    sfmt_next32(gen);
+	    sfmt_next32(gen2);
+	}
+	n = skips[k % 7];
+	if (sfmt_discard(gen, k % 2 ? table : NULL, n) != 0) {
+	    printf("\nsfmt_discard(%lu) failed\n", (unsigned long)n);
+	    exit(1);
+	}
+	for (; n > 0; n -= i) {
+	    i = n < (uint64_t)out_size ? (int)n : out_size;
+	    sfmt_fill_array32(gen2, out, i);
+	}
+	if (sfmt_next32(gen) != sfmt_next32(gen2)) {
+	    printf("\nmismatch of sfmt_discard(%lu)\n",
+		   (unsigned long)skips[k % 7]);
+	    exit(1);
+	}
+    }
+    /* 10^12 at once, and in two */
+    sfmt_init_gen_rand(gen, 1234);
+    sfmt_init_gen_rand(gen2, 1234);
+    sfmt_discard(gen, table, 1000000000000ULL);
+    sfmt_discard(gen2, table, 1000000000000ULL - 1000003);
+    for (n = 1000003; n > 0; n -= i) {
+	i = n < (uint64_t)out_size ? (int)n : out_size;
+	sfmt_fill_array32(gen2, out, i);
+    }
+    if (sfmt_next32(gen) != sfmt_next32(gen2)
+	|| sfmt_discard(gen, table, (uint64_t)1 << 62) == 0
+	|| sfmt_next32(gen) != sfmt_next32(gen2)) {
+	printf("\nmismatch of sfmt_discard(10^12)\n");
+	exit(1);
+    }
+    sfmt_close_jump_table(table);
+    remove(path);
+    sfmt_free(gen);
+    sfmt_free(gen2);
+#endif
+}
+
+/**
+ * This function checks the blocks of sfmt_index_block() against
+ * gen_rand_all() from the origin, for an index in memory and for its
+ * file mapped by sfmt_open_index(), and a block past the end by the
+ * jumps of a table for MEXP up to 19937, as check_jump().  Nothing is
+ * printed unless a mismatch is found.
+ */
+void check_index(void) {
+    int i;
+    uint64_t b;
+    char path[64];
+    char table_path[64];
+    uint64_t blocks[] = {0, 1, 255, 256, 257, 768, 999};
+    sfmt_index *index, *mapped;
+    sfmt_jump_table *table = NULL;
+
+    sprintf(path, "test-index-M%d.bin", MEXP);
+    init_gen_rand(4321, xsfmt[0]);
+    index = sfmt_new_index(MEXP, xsfmt[0], 1000, 4 * sizeof(sfmt));
+    if (index == NULL || index->k != 8 || index->count != 4
+	|| sfmt_new_index(MEXP, xsfmt[0], 1000, sizeof(sfmt) - 1) != NULL
+	|| sfmt_save_index(index, path) != 0
+	|| (mapped = sfmt_open_index(path, MEXP)) == NULL
+	|| sfmt_open_index(path, MEXP == 607 ? 1279 : 607) != NULL) {
+	printf("\nsfmt_new_index(%d) failed\n", MEXP);
+	exit(1);
+    }
+    memcpy(&sfmt[0], xsfmt[0], sizeof(sfmt));
+    for (b = 0, i = 0; b < 1000; b++) {
+	gen_rand_all(&sfmt[0]);
+	if (b != blocks[i]) {
+	    continue;
+	}
+	i++;
+	if (sfmt_index_block(index, NULL, b, xsfmt[1]) != 0
+	    || sfmt_index_block(mapped, NULL, b, xsfmt[2]) != 0
+	    || memcmp(&sfmt[0], xsfmt[1], sizeof(sfmt)) != 0
+	    || memcmp(&sfmt[0], xsfmt[2], sizeof(sfmt)) != 0) {
+	    printf("\nmismatch of sfmt_index_block(%d)\n", (int)b);
+	    exit(1);
+	}
+    }
+    if (sfmt_index_block(mapped, NULL, 1000, xsfmt[1]) == 0) {
+	printf("\nsfmt_index_block() made a block past the end\n");
+	exit(1);
+    }
+#if MEXP <= 19937
+    sprintf(table_path, "test-index-jump-M%d.bin", MEXP);
+    if (sfmt_write_jump_table(table_path, MEXP, 0, 40) != 0
+	|| (table = sfmt_open_jump_table(table_path, MEXP)) == NULL) {
+	printf("\nsfmt_write_jump_table(%d) failed\n", MEXP);
+	exit(1);
+    }
+    /* the block just past the end, near enough for gen_rand_all() */
+    gen_rand_all(&sfmt[0]);
+    if (sfmt_index_block(mapped, table, b, xsfmt[1]) != 0
+	|| memcmp(&sfmt[0], xsfmt[1], sizeof(sfmt)) != 0) {
+	printf("\nmismatch of sfmt_index_block(%d)\n", (int)b);
+	exit(1);
+    }
+    for (b++; b < 1000 + 2 * 128 * N; b++) {
+	gen_rand_all(&sfmt[0]);
+    }
+    if (sfmt_index_block(mapped, table, b - 1, xsfmt[1]) != 0
+	|| memcmp(&sfmt[0], xsfmt[1], sizeof(sfmt)) != 0) {
+	printf("\nmismatch of sfmt_index_block(%d)\n", (int)b - 1);
+	exit(1);
+    }
+    sfmt_close_jump_table(table);
+    remove(table_path);
+#else
+    (void)table;
+    (void)table_path;
+#endif
+    sfmt_free_index(index);
+    sfmt_free_index(mapped);
+    remove(path);
+}
+
+/** gen_rand_all() of a backend for a Mersenne exponent */
+#define DIRECT_NAME_(backend, mexp) SFMT_BACKEND_NAME(gen_rand_all, backend, mexp)
+/** gen_rand_all() of a backend for a Mersenne exponent, after expansion */
+#define DIRECT_NAME(backend, mexp) DIRECT_NAME_(backend, mexp)
+/** calls gen_rand_all() of a backend directly, if it is the bound one */
+#define DIRECT_GEN_RAND_ALL(backend, name, count)			\
+    if (strcmp((name), #backend) == 0) {				\
+	for (j = 0; j < (count); j++) {					\
+	    DIRECT_NAME(backend, MEXP)(&sfmt[0]);			\
+	}								\
+    }
+
+/**
+ * This function compares the speed of gen_rand_all() through the
+ * run-time dispatcher with that of the bound backend called directly.
+ */
+void speed_dispatch(void) {
+    int i, j;
+    int count = BLOCK_SIZE * COUNT / N32;
+    clock_t clo;
+    clock_t min_dispatch = LONG_MAX;
+    clock_t min_direct = LONG_MAX;
+    clock_t min_reverse = LONG_MAX;
+    const char *name = sfmt_get_backend();
+
+    printf("backend: %s\n", name);
+    init_gen_rand(1234, &sfmt[0]);
+    for (i = 0; i < 10; i++) {
+	clo = clock();
+	for (j = 0; j < count; j++) {
+	    gen_rand_all(&sfmt[0]);
+	}
+	clo = clock() - clo;
+	if (clo < min_dispatch) {
+	    min_dispatch = clo;
+	}
+	clo = clock();
+	DIRECT_GEN_RAND_ALL(std, name, count);
+	DIRECT_GEN_RAND_ALL(sse2, name, count);
+	DIRECT_GEN_RAND_ALL(avx2, name, count);
+	DIRECT_GEN_RAND_ALL(avx512, name, count);
+	clo = clock() - clo;
+	if (clo < min_direct) {
+	    min_direct = clo;
+	}
+	clo = clock();
+	for (j = 0; j < count; j++) {
+	    gen_rand_all_reverse(&sfmt[0]);
+	}
+	clo = clock() - clo;
+	if (clo < min_reverse) {
+	    min_reverse = clo;
+	}
+    }
+    printf("DISPATCH ALL:%.0f", (double)min_dispatch * 1000 / CLOCKS_PER_SEC);
+    printf("ms for %d calls of gen_rand_all\n", count);
+    printf("DIRECT   ALL:%.0f", (double)min_direct * 1000 / CLOCKS_PER_SEC);
+    printf("ms for %d calls of gen_rand_all\n", count);
+    printf("REVERSE  ALL:%.0f", (double)min_reverse * 1000 / CLOCKS_PER_SEC);
+    printf("ms for %d calls of gen_rand_all_reverse\n", count);
+    speed_bounded();
+    speed_normal();
+    speed_lanes();
+    speed_latency();
+}
+
+/**
+ * This function compares the speed of sfmt_fill_array_bounded() with
+ * that of sfmt_next_bounded() and of the biased sfmt_next32() % n.
+ */
+void speed_bounded(void) {
+    int i, j, k;
+    clock_t clo;
+    clock_t min[3] = {LONG_MAX, LONG_MAX, LONG_MAX};
+    uint32_t *array32 = (uint32_t *)array1;
+    uint32_t n = 1000;
+    sfmt_t *gen = sfmt_new(MEXP);
+
+    sfmt_init_gen_rand(gen, 1234);
+    for (i = 0; i < 10; i++) {
+	clo = clock();
+	for (j = 0; j < COUNT; j++) {
+	    sfmt_fill_array_bounded(gen, array32, BLOCK_SIZE, n);
+	}
+	clo = clock() - clo;
+	if (clo < min[0]) {
+	    min[0] = clo;
+	}
+	clo = clock();
+	for (j = 0; j < COUNT; j++) {
+	    for (k = 0; k < BLOCK_SIZE; k++) {
+		array32[k] = sfmt_next_bounded(gen, n);
+	    }
+	}
+	clo = clock() - clo;
+	if (clo < min[1]) {
+	    min[1] = clo;
+	}
+	clo = clock();
+	for (j = 0; j < COUNT; j++) {
+	    for (k = 0; k < BLOCK_SIZE; k++) {
+		array32[k] = sfmt_next32(gen) % n;
+	    }
+	}
+	clo = clock() - clo;
+	if (clo < min[2]) {
+	    min[2] = clo;
+	}
+    }
+    printf("BOUNDED BLOCK:%.0f", (double)min[0] * 1000 / CLOCKS_PER_SEC);
+    printf("ms for %u randoms generation\n", BLOCK_SIZE * COUNT);
+    printf("BOUNDED SEQUE:%.0f", (double)min[1] * 1000 / CLOCKS_PER_SEC);
+    printf("ms for %u randoms generation\n", BLOCK_SIZE * COUNT);
+    printf("MODULO  SEQUE:%.0f", (double)min[2] * 1000 / CLOCKS_PER_SEC);
+    printf("ms for %u randoms generation\n", BLOCK_SIZE * COUNT);
+    sfmt_free(gen);
+}
+/**
+ * This function compares the speed of sfmt_fill_array_normal() with
+ * that of sfmt_next_normal() and of the Box-Muller transform of
+ * sfmt_next_double().
+ */
+void speed_normal(void) {
+    int i, j, k;
+    clock_t clo;
+    clock_t min[3] = {LONG_MAX, LONG_MAX, LONG_MAX};
+    double *array = (double *)array1;
+    double r, t;
+    sfmt_t *gen = sfmt_new(MEXP);
+
+    sfmt_init_gen_rand(gen, 1234);
+    for (i = 0; i < 10; i++) {
+	clo = clock();
+	for (j = 0; j < COUNT; j++) {
+	    sfmt_fill_array_normal(gen, array, BLOCK_SIZE64);
+	}
+	clo = clock() - clo;
+	if (clo < min[0]) {
+	    min[0] = clo;
+	}
+	clo = clock();
+	for (j = 0; j < COUNT; j++) {
+	    for (k = 0; k < BLOCK_SIZE64; k++) {
+		array[k] = sfmt_next_normal(gen);
+	    }
+	}
+	clo = clock() - clo;
+	if (clo < min[1]) {
+	    min[1] = clo;
+	}
+	clo = clock();
+	for (j = 0; j < COUNT; j++) {
+	    for (k = 0; k < BLOCK_SIZE64; k += 2) {
+		r = sqrt(-2.0 * log(1.0 - sfmt_next_double(gen)));
+		t = 6.283185307179586 * sfmt_next_double(gen);
+		array[k] = r * cos(t);
+		array[k + 1] = r * sin(t);
+	    }
+	}
+	clo = clock() - clo;
+	if (clo < min[2]) {
+	    min[2] = clo;
+	}
+    }
+    printf("NORMAL BLOCK:%.0f", (double)min[0] * 1000 / CLOCKS_PER_SEC);
+    printf("ms for %u randoms generation\n", BLOCK_SIZE64 * COUNT);
+    printf("NORMAL SEQUE:%.0f", (double)min[1] * 1000 / CLOCKS_PER_SEC);
+    printf("ms for %u randoms generation\n", BLOCK_SIZE64 * COUNT);
+    printf("BOXMUL SEQUE:%.0f", (double)min[2] * 1000 / CLOCKS_PER_SEC);
+    printf("ms for %u randoms generation\n", BLOCK_SIZE64 * COUNT);
+    sfmt_free(gen);
+}
+
+/**
+ * This function compares the speed of sfmt_fill_array32_lanes() into
+ * 8 lanes with that of sfmt_fill_array32() followed by a gather with a
+ * stride of 8.
+ */
+void speed_lanes(void) {
+    int i, j, k, r;
+    clock_t clo;
+    clock_t min[2] = {LONG_MAX, LONG_MAX};
+    uint32_t *array = (uint32_t *)array1;
+    uint32_t *lanes[8];
+    uint32_t *tmp = (uint32_t *)array2;
+    sfmt_t *gen = sfmt_new(MEXP);
+
+    for (j = 0; j < 8; j++) {
+	lanes[j] = array + j * (BLOCK_SIZE / 8);
+    }
+    sfmt_init_gen_rand(gen, 1234);
+    for (i = 0; i < 10; i++) {
+	clo = clock();
+	for (j = 0; j < COUNT; j++) {
+	    sfmt_fill_array32_lanes(gen, lanes, 8, BLOCK_SIZE / 8);
+	}
+	clo = clock() - clo;
+	if (clo < min[0]) {
+	    min[0] = clo;
+	}
+	clo = clock();
+	for (j = 0; j < COUNT; j++) {
+	    for (r = 0; r < BLOCK_SIZE / 8; r += 500) {
+		sfmt_fill_array32(gen, tmp, 4000);
+		for (k = 0; k < 4000; k++) {
+		    lanes[k % 8][r + k / 8] = tmp[k];
+		}
+	    }
+	}
+	clo = clock() - clo;
+	if (clo < min[1]) {
+	    min[1] = clo;
+	}
+    }
+    printf("LANES  BLOCK:%.0f", (double)min[0] * 1000 / CLOCKS_PER_SEC);
+    printf("ms for %u randoms generation\n", BLOCK_SIZE * COUNT);
+    printf("GATHER BLOCK:%.0f", (double)min[1] * 1000 / CLOCKS_PER_SEC);
+    printf("ms for %u randoms generation\n", BLOCK_SIZE * COUNT);
+    sfmt_free(gen);
+}
+
+/** the number of the bins of the latency histograms */
+#define LATENCY_BINS 12
+
+/**
+ * This function prints the histograms of the latency of a call of
+ * sfmt_next32() and of sfmt_inc_next32() with slices of 4 and 1, in
+ * cycles of the time stamp counter with its overhead, the bin b for
+ * 2^(b + 4) to 2^(b + 5) - 1 cycles.  The 99.99th percentile is the
+ * upper end of its bin.  As a call costs the same at the same index of
+ * every table but for interrupts, the worst case is the most, over the
+ * indexes, of the least latency of the calls at an index, less the
+ * least overhead of the counter.
+ */
+void speed_latency(void) {
+#if defined(HAVE_RDTSC)
+    int i, k, b;
+    int count = BLOCK_SIZE * 10;
+    int slices[2] = {4, 1};
+    uint64_t t;
+    uint64_t hist[3][LATENCY_BINS];
+    uint64_t max[3] = {0, 0, 0};
+    uint64_t worst[3] = {0, 0, 0};
+    uint64_t overhead = UINT64_MAX;
+    uint64_t sum;
+    int p9999[3];
+    uint32_t x[3] = {0, 0, 0};
+    uint64_t *least = malloc(sizeof(uint64_t) * N32);
+    sfmt_t *gen = sfmt_new(MEXP);
+    sfmt_inc_t *inc[2];
+
+    sfmt_init_gen_rand(gen, 1234);
+    for (k = 0; k < 2; k++) {
+	inc[k] = sfmt_new_inc(gen, slices[k]);
+    }
+    memset(hist, 0, sizeof(hist));
+    for (i = 0; i < count; i++) {
+	t = __rdtsc();
+	t = __rdtsc() - t;
+	if (t < overhead) {
+	    overhead = t;
+	}
+    }
+    /* one generator at a time, the tables of the others out of the way */
+    for (k = 0; k < 3; k++) {
+	for (i = 0; i < N32; i++) {
+	    least[i] = UINT64_MAX;
+	}
+	for (i = 0; i < count; i++) {
+	    t = __rdtsc();
+	    x[k] ^= k == 0 ? sfmt_next32(gen) : sfmt_inc_next32(inc[k - 1]);
+	    t = __rdtsc() - t;
+	    for (b = 0; b < LATENCY_BINS - 1 && t >= ((uint64_t)32 << b); b++) {
+	    }
+	    hist[k][b]++;
+	    if (t > max[k]) {
+		max[k] = t;
+	    }
+	    if (t < least[i % N32]) {
+		least[i % N32] = t;
+	    }
+	}
+	for (i = 0; i < N32; i++) {
+	    if (least[i] - overhead > worst[k]) {
+		worst[k] = least[i] - overhead;
+	    }
+	}
+    }
+    if (x[0] != x[1] || x[0] != x[2]) {
+	printf("\nmismatch of sfmt_inc_next32\n");
+	exit(1);
+    }
+    for (k = 0; k < 3; k++) {
+	sum = 0;
+	for (b = 0; sum + hist[k][b] < count - count / 10000; b++) {
+	    sum += hist[k][b];
+	}
+	p9999[k] = b;
+    }
+    printf("LATENCY cycles    next32     inc/4     inc/1 (%d calls)\n",
+	   count);
+    for (b = 0; b < LATENCY_BINS; b++) {
+	if (hist[0][b] == 0 && hist[1][b] == 0 && hist[2][b] == 0) {
+	    continue;
+	}
+	if (b == LATENCY_BINS - 1) {
+	    printf("%7d-       ", 16 << b);
+	} else {
+	    printf("%7d-%-7d", b == 0 ? 0 : 16 << b, (32 << b) - 1);
+	}
+	printf("%9"PRIu64" %9"PRIu64" %9"PRIu64"\n",
+	       hist[0][b], hist[1][b], hist[2][b]);
+    }
+    printf("p99.99 <     %9d %9d %9d\n",
+	   32 << p9999[0], 32 << p9999[1], 32 << p9999[2]);
+    printf("max          %9"PRIu64" %9"PRIu64" %9"PRIu64"\n",
+	   max[0], max[1], max[2]);
+    printf("worst case   %9"PRIu64" %9"PRIu64" %9"PRIu64"\n",
+	   worst[0], worst[1], worst[2]);
+    for (k = 0; k < 2; k++) {
+	sfmt_free_inc(inc[k]);
+    }
+    sfmt_free(gen);
+    free(least);
+#endif
+}
+#endif
+
+void paramdump(void) {
+    printf("MEXP = %d\n", MEXP);
+    printf("N = %d\n", N);
+    printf("N32 = %d\n", N32);
+    printf("POS1 = %d\n", POS1);
+    printf("SL1 = %d\n", SL1);
+    printf("SL2 = %d\n", SL2);
+    printf("SR1 = %d\n", SR1);
+    printf("SR2 = %d\n", SR2);
+    printf("MSK1 = %#010xU\n", MSK1);
+    printf("MSK2 = %#010xU\n", MSK2);
+    printf("MSK3 = %#010xU\n", MSK3);
+    printf("MSK4 = %#010xU\n", MSK4);
+    printf("PARITY1 = %#010xU\n", PARITY1);
+    printf("PARITY2 = %#010xU\n", PARITY2);
+    printf("PARITY3 = %#010xU\n", PARITY3);
+    printf("PARITY4 = %#010xU\n", PARITY4);
+    printf("IDSTR = %s\n", IDSTR);
+    printf("sizeof(sfmt) = %d\n", sizeof(sfmt));
+}
+
+int main(int argc, char *argv[]) {
+    int i;
+    int speed = 0;
+    int bit32 = 0;
+    int bit64 = 0;
+    int param = 0;
+
+    for (i = 1; i < argc; i++) {
+	if (strncmp(argv[1],"-s", 2) == 0) {
+	    speed = 1;
+	}
+	if (strncmp(argv[1],"-b32", 4) == 0) {
+	    bit32 = 1;
+	}
+	if (strncmp(argv[1],"-b64", 4) == 0) {
+	    bit64 = 1;
+	}
+	if (strncmp(argv[1],"-p", 2) == 0) {
+	    param = 1;
+	}
+    }
+    if (speed + bit32 + bit64 + param == 0) {
+	printf("usage:\n%s [-s | -b32 | -b64 | -p]\n", argv[0]);
+	return 0;
+    }
+    if (speed) {
+	speed32();
+	speed64();
+#if defined(SFMT_DISPATCH)
+	speed_dispatch();
+#endif
+    }
+    if (bit32) {
+	check32();
+	check32x(2);
+	check32x(4);
+	check_real();
+	check_reverse();
+	check_slice();
+#if defined(SFMT_DISPATCH)
+	check_params();
+	check_gen();
+	check_bounded();
+	check_normal();
+	check_lanes();
+	check_jump();
+	check_jump_table();
+	check_pool();
+	check_ring();
+	check_inc();
+	check_watermark();
+	check_shared();
+	check_local();
+	check_discard();
+	check_index();
+#endif
+    }
+    if (bit64) {
+	check64();
     }
     if (param) {
 	paramdump();
@@ -0,0 +1,156 @@
+/* This file is a part of sfmt-extstate */
+
+/**
+ * @file  test_engine.cpp
+ * @brief test program for sfmt-engine.hpp
+ *
+ * @author Kenji Rikitake
+ *
+ * Copyright (C) 2010 Kenji Rikitake. All rights reserved.
+ *
+ * The new BSD License is applied to this software, see LICENSE.txt
+ *
+ * @note The output of -b32 is the same as that of test.c, for
+ * check.sh.  Compile with -DMEXP=607 etc. to choose the parameter set.
+ */
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <climits>
+#include <random>
+#include <utility>
+#include "sfmt-engine.hpp"
+
+#if !defined(MEXP)
+  #define MEXP 19937
+#endif
+
+#define BLOCK_SIZE 100000
+#define COUNT 1000
+
+/** the engine of MEXP */
+typedef sfmt_engine<SFMT_PASTE(sfmt_traits_M, MEXP)> engine_t;
+
+void check32(void);
+void check_engine(void);
+void speed32(void);
+
+void check32(void) {
+    int i;
+    uint32_t ini[4] = {0x1234, 0x5678, 0x9abc, 0xdef0};
+    engine_t sfmt(1234);
+
+    printf("%s\n32 bit generated randoms\n", engine_t::idstring());
+    printf("init_gen_rand__________\n");
+    for (i = 0; i < 1000; i++) {
+	printf("%10u ", sfmt());
+	if (i % 5 == 4) {
+	    printf("\n");
+	}
+    }
+    printf("\n");
+    sfmt.seed(ini, 4);
+    printf("init_by_array__________\n");
+    for (i = 0; i < 1000; i++) {
+	printf("%10u ", sfmt());
+	if (i % 5 == 4) {
+	    printf("\n");
+	}
+    }
+}
+
+/**
+ * This function checks the copies, the moves and discard() against
+ * an engine which is only called, discard() also within a table, to
+ * the end of a table, over one more whole table and over several
+ * tables from a seeded engine.  Nothing is printed unless a mismatch is
+ * found.
+ */
+void check_engine(void) {
+    int i, j, k;
+    /* with one output between them, to 6, to n32, to 3 n32 and on */
+    const int skips[] = {0, 5, engine_t::n32 - 7, 2 * engine_t::n32 - 1,
+			 5 * engine_t::n32 + 7, 1};
+    engine_t a(4321);
+    engine_t b(4321);
+    engine_t c;
+    std::uniform_int_distribution<int> dist(1, 6);
+
+    for (i = 0; i < engine_t::n32 + 3; i++) {
+	a();
+    }
+    b.discard(engine_t::n32 + 3);
+    c = a;
+    engine_t d(c);
+    engine_t e(std::move(c));
+    /* the copies of a moved-from engine, seeded again */
+    engine_t f(c);
+    d = c;
+    f.seed(1234);
+    d.seed(1234);
+    if (f() != d()) {
+	printf("\nmismatch of the copies of a moved-from engine\n");
+	exit(1);
+    }
+    d = e;
+    c = std::move(d);
+    for (i = 0; i < 3 * engine_t::n32; i++) {
+	uint32_t r = a();
+	if (b() != r || c() != r || e() != r) {
+	    printf("\nmismatch at %d of the copies\n", i);
+	    exit(1);
+	}
+    }
+    for (i = 0; i < 1000; i++) {
+	int r = dist(a);
+	if (r < 1 || r > 6 || dist(b) != r) {
+	    printf("\nmismatch at %d of uniform_int_distribution\n", i);
+	    exit(1);
+	}
+    }
+    a.seed(5678);
+    b.seed(5678);
+    for (k = 0; k < (int)(sizeof(skips) / sizeof(skips[0])); k++) {
+	for (j = 0; j < skips[k]; j++) {
+	    a();
+	}
+	b.discard(skips[k]);
+	if (a() != b()) {
+	    printf("\nmismatch after discard(%d)\n", skips[k]);
+	    exit(1);
+	}
+    }
+}
+
+void speed32(void) {
+    int i, j;
+    clock_t clo;
+    clock_t min = LONG_MAX;
+    engine_t sfmt(1234);
+
+    for (i = 0; i < 10; i++) {
+	clo = clock();
+	for (j = 0; j < BLOCK_SIZE * COUNT; j++) {
+	    sfmt();
+	}
+	clo = clock() - clo;
+	if (clo < min) {
+	    min = clo;
+	}
+    }
+    printf("32 bit ENGINE:%.0f", (double)min * 1000 / CLOCKS_PER_SEC);
+    printf("ms for %u randoms generation\n", BLOCK_SIZE * COUNT);
+}
+
+int main(int argc, char *argv[]) {
+    if (argc > 1 && strncmp(argv[1], "-s", 2) == 0) {
+	speed32();
+    } else if (argc > 1 && strncmp(argv[1], "-b32", 4) == 0) {
+	check32();
+	check_engine();
+    } else {
+	printf("usage:\n%s [-s | -b32]\n", argv[0]);
+    }
+    return 0;
+}